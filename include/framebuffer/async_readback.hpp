@@ -0,0 +1,58 @@
+#ifndef ASYNC_READBACK_HPP
+#define ASYNC_READBACK_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "glad/glad.h"
+#include "framebuffer/framebuffer.hpp"
+#include "framebuffer/pixel_buffer.hpp"
+#include "texture/rect.hpp"
+
+/* Pixels of a region read back from a framebuffer (filled once `is_ready`) */
+struct ReadbackResult {
+  Rect rect;
+  GLenum format;
+  GLenum type;
+  bool is_ready;
+
+  /* tightly-packed rows from bottom to top (like `glReadPixels()`) */
+  std::vector<unsigned char> data;
+};
+
+/* Polled by calling code (e.g. picking), or ignored when a callback is given */
+using ReadbackHandle = std::shared_ptr<const ReadbackResult>;
+using ReadbackCallback = std::function<void(const ReadbackResult&)>;
+
+/**
+ * Non-blocking reads of framebuffer pixels (picking, screenshots, cpu analysis)
+ * Each read is copied into a pixel pack buffer from a pool & fenced, `update()` (once per frame)
+ * delivers finished ones in order a few frames later, instead of stalling like `Framebuffer::get_pixel_value()`
+ * Pool grows when all buffers are in flight (reads never wait for the gpu)
+ */
+struct AsyncReadback {
+  AsyncReadback(unsigned int n_buffers=3);
+  ReadbackHandle read_pixel(const Framebuffer& framebuffer, int x, int y, GLenum format, GLenum type=GL_UNSIGNED_BYTE, const ReadbackCallback& callback=nullptr);
+  ReadbackHandle read_rect(const Framebuffer& framebuffer, const Rect& rect, GLenum format, GLenum type=GL_UNSIGNED_BYTE, const ReadbackCallback& callback=nullptr);
+  ReadbackHandle read_attachment(const Framebuffer& framebuffer, GLenum format, GLenum type=GL_UNSIGNED_BYTE, const ReadbackCallback& callback=nullptr);
+  void update();
+  unsigned int get_n_pending() const;
+  void free();
+
+private:
+  struct Request {
+    unsigned int i_buffer;
+    std::shared_ptr<ReadbackResult> result;
+    ReadbackCallback callback;
+  };
+
+  std::vector<PixelBuffer> m_buffers;
+  std::vector<unsigned int> m_free_buffers;
+
+  /* in order of submission (fences signaled in the same order) */
+  std::deque<Request> m_requests;
+};
+
+#endif // ASYNC_READBACK_HPP
@@ -0,0 +1,42 @@
+#ifndef CANVAS_MIRROR_HPP
+#define CANVAS_MIRROR_HPP
+
+#include <deque>
+#include <vector>
+
+#include "framebuffer/framebuffer.hpp"
+#include "framebuffer/async_readback.hpp"
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+
+/**
+ * Cpu copy of a framebuffer's color attachment (e.g. canvas in <imgui-paint>) for color picking without stalls
+ * Regions drawn on the gpu are read back asynchronously (with `AsyncReadback`) a few frames later,
+ * so `get_pixel_value()` is answered from memory instead of a synchronous `glReadPixels()`
+ * Values can lag behind the gpu by the readback latency
+ */
+struct CanvasMirror {
+  CanvasMirror(const Framebuffer& framebuffer, unsigned int n_buffers=3);
+  void mark_dirty(const Rect& rect);
+  void update();
+  bool is_synced() const;
+  void get_pixel_value(int x, int y, unsigned char* data) const;
+  Image get_image() const;
+  void free();
+
+private:
+  Framebuffer m_framebuffer;
+  GLenum m_format;
+  std::vector<unsigned char> m_data;
+
+  AsyncReadback m_readback;
+  unsigned int m_max_pending;
+
+  /* readbacks in flight (in order of submission) */
+  std::deque<ReadbackHandle> m_pending;
+
+  /* drawn since last readback */
+  Rect m_dirty;
+};
+
+#endif // CANVAS_MIRROR_HPP
@@ -1,14 +1,19 @@
 #ifndef FRAMEBUFFER_HPP
 #define FRAMEBUFFER_HPP
 
+#include <vector>
+
 #include "glad/glad.h"
 #include "texture/texture_2d.hpp"
 
 /**
  * Wrapper around OpenGL's framebuffer object (FBO)
+ * Several color attachments (each with its own format) written at once by fragment shader outputs at the same locations
+ * (e.g. G-buffer), plus an optional depth or depth-stencil attachment
  * https://learnopengl.com/Advanced-OpenGL/Framebuffers
  */
 struct Framebuffer {
+  /* of color attachment 0 (size of depth attachment for depth-only framebuffers, e.g. shadow maps) */
   int width;
   int height;
   int n_channels;
@@ -19,14 +24,62 @@ struct Framebuffer {
   void bind() const;
   void unbind() const;
   void clear(const glm::vec4& color);
+  void clear_color(unsigned int i_attachment, const glm::vec4& color);
+  void clear_color_uint(unsigned int i_attachment, const glm::uvec4& value);
+  void clear_depth(float depth=1.0f, int stencil=0);
+  void invalidate(const std::vector<GLenum>& attachments);
+  void invalidate_depth();
   void get_pixel_value(int x, int y, unsigned char* data);
-  void attach_texture(const Texture2D& texture);
+  void attach_texture(const Texture2D& texture, unsigned int i_attachment=0);
+  void attach_depth(const Texture2D& texture);
+  void attach_depth(GLenum internal_format=GL_DEPTH_COMPONENT24);
+  void attach_multisample(int w, int h, int n_samples, GLenum internal_format=GL_RGBA8, unsigned int i_attachment=0);
+  void resolve(const Texture2D& texture, unsigned int i_attachment=0);
 
 private:
   GLuint m_id;
   GLenum m_format;
 
+  /* `GL_COLOR_ATTACHMENTi` at index i (GL_NONE for gaps, so shader output locations match attachment indices) */
+  std::vector<GLenum> m_draw_buffers;
+
+  /* whether color attachment i has an integer format (e.g. GL_R32UI ids, can't be cleared with floats) */
+  std::vector<bool> m_is_integer;
+
+  /* depth renderbuffer (0 if none or depth texture attached) */
+  GLuint m_id_depth;
+
+  /* GL_DEPTH_ATTACHMENT, GL_DEPTH_STENCIL_ATTACHMENT, or GL_NONE */
+  GLenum m_depth_attachment;
+
+  /* multisampled color renderbuffer of attachment i (0 if none) & # of samples per pixel (0 if single-sampled) */
+  std::vector<GLuint> m_ids_color;
+  int m_n_samples;
+
+  /* framebuffer with texture that multisampled attachments are resolved to (0 until first `resolve()`) */
+  GLuint m_id_resolve;
+
+  /* linear colors written by shaders encoded to sRGB by hardware (blending done in linear space) */
+  bool m_is_srgb;
+
+  /* GL_FRAMEBUFFER_SRGB state before `bind()`, restored by `unbind()` (other targets may rely on it) */
+  mutable bool m_was_srgb_enabled;
+
+  /* draw framebuffer & sRGB state restored after a clear/invalidate */
+  struct DrawBinding {
+    GLint id_previous;
+    bool was_srgb_enabled;
+  };
+
   void generate();
+  DrawBinding bind_draw() const;
+  void unbind_draw(const DrawBinding& binding) const;
+  void add_draw_buffer(unsigned int i_attachment, bool is_integer);
+  void delete_renderbuffer(unsigned int i_attachment);
+  static bool is_integer_format(GLenum format);
+  static GLenum get_pixel_format(GLenum internal_format);
+  GLenum get_read_buffer() const;
+  static GLenum get_depth_attachment(GLenum format);
 };
 
 #endif
@@ -0,0 +1,36 @@
+#ifndef PIXEL_BUFFER_HPP
+#define PIXEL_BUFFER_HPP
+
+#include "glad/glad.h"
+#include "framebuffer/framebuffer.hpp"
+
+/**
+ * Pixel pack buffer (PBO) for asynchronous readback of a framebuffer region
+ * `glReadPixels()` into a PBO returns immediately, a fence tells when the copy is done
+ * https://www.khronos.org/opengl/wiki/Pixel_Buffer_Object
+ */
+struct PixelBuffer {
+  PixelBuffer();
+  bool read(const Framebuffer& framebuffer, int x, int y, int width, int height, GLenum format, GLenum type=GL_UNSIGNED_BYTE);
+  bool is_pending() const;
+  bool is_ready();
+  const unsigned char* map();
+  void unmap();
+  size_t get_n_bytes() const;
+  void free();
+
+private:
+  GLuint m_id;
+  GLsync m_fence;
+
+  /* allocated size (buffer only reallocated when a bigger region is read) */
+  size_t m_n_bytes;
+
+  /* size of last region read (tightly packed) */
+  size_t m_n_bytes_read;
+
+  static int get_n_components(GLenum format);
+  static int get_n_bytes_component(GLenum type);
+};
+
+#endif // PIXEL_BUFFER_HPP
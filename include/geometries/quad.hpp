@@ -0,0 +1,19 @@
+#ifndef QUAD_HPP
+#define QUAD_HPP
+
+#include "geometries/geometry.hpp"
+
+/* Quad covering the whole viewport (2d positions in NDC) drawn as a triangle strip for post-processing passes */
+namespace geometry {
+  class Quad : public Geometry {
+  public:
+    Quad();
+
+  private:
+    void set_vertexes();
+    void set_indices();
+    void set_positions();
+  };
+}
+
+#endif // QUAD_HPP
@@ -0,0 +1,60 @@
+#ifndef CONTEXT_LOADER_HPP
+#define CONTEXT_LOADER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glad/glad.h"
+#include "geometries/geometry.hpp"
+#include "shader/program.hpp"
+#include "texture/texture_2d.hpp"
+#include "texture/wrapping.hpp"
+#include "vertexes/vbo.hpp"
+
+/**
+ * Thread creating GL objects (textures, buffers, programs) on a 2nd context sharing objects with the main one
+ * Decoding & upload leave the frame loop, objects handed over once a fence signals the gpu is done with them
+ * Context (window, EGL or OSMesa) created by calling code & made current on the loader thread via `make_current`
+ * VAOs aren't shared between contexts => `Renderer` still created on the main thread (from a loaded VBO)
+ */
+struct ContextLoader {
+  ContextLoader(const std::function<void()>& make_current, const std::function<void()>& release_current=nullptr);
+  ~ContextLoader();
+
+  std::shared_future<Texture2D> load_texture(const std::string& path, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool flip=true);
+  std::shared_future<VBO> load_vbo(const std::shared_ptr<const Geometry>& geometry);
+  std::shared_future<Program> load_program(const std::string& path_vertex, const std::string& path_fragment);
+
+  void poll();
+  void stop();
+
+private:
+  /* object created on loader thread, waiting for its fence to be signaled */
+  struct Pending {
+    GLsync fence;
+    std::function<void()> fulfill;
+  };
+
+  std::thread m_thread;
+  std::queue<std::function<void()>> m_jobs;
+  std::vector<Pending> m_pending;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_is_stopped;
+
+  void run(const std::function<void()>& make_current, const std::function<void()>& release_current);
+  void add_pending(GLsync fence, const std::function<void()>& fulfill);
+
+  /* only instantiated for the loaded types above (defined in translation unit) */
+  template <typename T>
+  std::shared_future<T> submit(const std::function<T()>& create);
+};
+
+#endif // CONTEXT_LOADER_HPP
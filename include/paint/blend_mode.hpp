@@ -0,0 +1,13 @@
+#ifndef BLEND_MODE_HPP
+#define BLEND_MODE_HPP
+
+/* how a layer is combined with layers below it: https://www.w3.org/TR/compositing-1/#blending */
+enum class BlendMode {
+  NORMAL,
+  MULTIPLY,
+  SCREEN,
+  OVERLAY,
+  ADD
+};
+
+#endif // BLEND_MODE_HPP
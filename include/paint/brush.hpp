@@ -0,0 +1,41 @@
+#ifndef BRUSH_HPP
+#define BRUSH_HPP
+
+#include <glm/glm.hpp>
+
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+
+/**
+ * Cpu brush painting anti-aliased circular stamps on an image (canvas in <imgui-paint>)
+ * Strokes interpolated between mouse positions, so stroke continuity doesn't depend on # of uploads
+ * Returned rectangles are meant for `DirtyRegion::add()`
+ */
+struct Brush {
+  /* in pixels */
+  float radius;
+
+  /* rgba in [0, 1] */
+  glm::vec4 color;
+
+  /* radius fraction with full coverage (1 => hard edge with only 1px anti-aliasing) */
+  float hardness;
+
+  /* distance between successive stamps as a fraction of the diameter */
+  float spacing;
+
+  float opacity;
+
+  Brush(float r, const glm::vec4& c, float h=1.0f, float s=0.25f, float o=1.0f);
+  Rect stamp(Image& image, const glm::vec2& center) const;
+  Rect begin_stroke(Image& image, const glm::vec2& position);
+  Rect continue_stroke(Image& image, const glm::vec2& position);
+
+private:
+  glm::vec2 m_position;
+
+  /* remaining distance along stroke until next stamp */
+  float m_distance_next;
+};
+
+#endif // BRUSH_HPP
@@ -0,0 +1,57 @@
+#ifndef COMPOSITOR_HPP
+#define COMPOSITOR_HPP
+
+#include <vector>
+
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+#include "paint/layer.hpp"
+
+/**
+ * Flattens a stack of layers (first one at the bottom) into one rgba image for display & save
+ * Blending done in premultiplied alpha on floats (one pixel per SSE2 vector)
+ * Only tiles marked as dirty are recomposed, and layers below the active one are cached flattened,
+ * so painting on the active layer only blends it with the cache & layers above it
+ */
+struct Compositor {
+  Compositor(int width, int height, int tile_size=64);
+  void add_layer(const Layer& layer);
+  Layer& get_layer(unsigned int i_layer);
+  unsigned int get_n_layers() const;
+
+  void set_active(unsigned int i_layer);
+  void mark_dirty(unsigned int i_layer, const Rect& rect);
+  void mark_dirty(unsigned int i_layer);
+  std::vector<Rect> compose();
+  Image get_image() const;
+
+private:
+  int m_width;
+  int m_height;
+  int m_tile_size;
+  int m_n_tiles_x;
+  int m_n_tiles_y;
+
+  std::vector<Layer> m_layers;
+  unsigned int m_i_active;
+
+  /**
+   * layers below active one flattened (premultiplied alpha)
+   * Kept as floats (not quantized to bytes), so output doesn't depend on which layer is active
+   */
+  std::vector<float> m_below;
+
+  /* composited image (straight alpha) */
+  std::vector<unsigned char> m_output;
+
+  std::vector<bool> m_is_dirty_below;
+  std::vector<bool> m_is_dirty_output;
+
+  /* premultiplied floats of tile being composited */
+  std::vector<float> m_tile;
+
+  Rect get_tile_rect(unsigned int i_tile) const;
+  void blend_layer(const Layer& layer, const Rect& rect);
+};
+
+#endif // COMPOSITOR_HPP
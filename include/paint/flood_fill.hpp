@@ -0,0 +1,47 @@
+#ifndef FLOOD_FILL_HPP
+#define FLOOD_FILL_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+
+/**
+ * Paint bucket & magic wand of <imgui-paint>: 4-connected region of pixels close to the seed's color
+ * Scanline spans pushed on a stack (no recursion per pixel), stack & mask buffers reused across calls
+ */
+struct FloodFill {
+  /* max difference per channel with seed color (in [0, 255]) */
+  int tolerance;
+
+  FloodFill(int t=0);
+  Rect fill(Image& image, const glm::ivec2& seed, const glm::vec4& color);
+  Rect select(const Image& image, const glm::ivec2& seed);
+  const std::vector<unsigned char>& get_mask() const;
+
+private:
+  struct Seed {
+    int x;
+    int y;
+  };
+
+  std::vector<Seed> m_stack;
+
+  /* 255 for pixels in region (row-major, same size as last image) */
+  std::vector<unsigned char> m_mask;
+  int m_width;
+  Rect m_rect;
+
+  /* per-call state used by span helpers */
+  const Image* m_image;
+  unsigned char m_color_seed[4];
+
+  bool is_match(int x, int y) const;
+  unsigned int get_matches(int x, int y) const;
+  int extend_left(int x, int y) const;
+  int extend_right(int x, int y, int x_end) const;
+  int skip_mismatches(int x, int y, int x_end) const;
+};
+
+#endif // FLOOD_FILL_HPP
@@ -0,0 +1,15 @@
+#ifndef LAYER_HPP
+#define LAYER_HPP
+
+#include "texture/image.hpp"
+#include "paint/blend_mode.hpp"
+
+/* Layer of a document in <imgui-paint> (rgba image with straight alpha, freed by calling code) */
+struct Layer {
+  Image image;
+  float opacity;
+  bool is_visible;
+  BlendMode blend_mode;
+};
+
+#endif // LAYER_HPP
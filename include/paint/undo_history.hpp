@@ -0,0 +1,63 @@
+#ifndef UNDO_HISTORY_HPP
+#define UNDO_HISTORY_HPP
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+
+/**
+ * Undo/redo for a canvas image in <imgui-paint> without a snapshot of the whole image per action
+ * Image split into square tiles, an action only keeps the tiles it modified (before & after),
+ * tiles are immutable & shared between the current state & actions (copy-on-write)
+ * Usage: `commit()` after each action with its dirty rectangle, upload rectangles returned by `undo()`/`redo()`
+ */
+struct UndoHistory {
+  UndoHistory(const Image& image, int tile_size=64, size_t max_bytes=256 << 20, bool is_compressed=true);
+  void commit(const Rect& rect);
+  std::vector<Rect> undo();
+  std::vector<Rect> redo();
+  bool can_undo() const;
+  bool can_redo() const;
+  size_t get_n_bytes() const;
+
+private:
+  /* Pixels of a tile, run-length encoded when it makes them smaller */
+  struct Tile {
+    std::vector<unsigned char> data;
+    bool is_compressed;
+  };
+
+  struct Change {
+    unsigned int i_tile;
+    std::shared_ptr<const Tile> before;
+    std::shared_ptr<const Tile> after;
+  };
+
+  using Action = std::vector<Change>;
+
+  Image m_image;
+  int m_tile_size;
+  int m_n_tiles_x;
+  int m_n_tiles_y;
+  size_t m_max_bytes;
+  bool m_is_compressed;
+
+  /* tiles of last committed state */
+  std::vector<std::shared_ptr<const Tile>> m_tiles;
+
+  /* actions after `m_n_applied` are redoable */
+  std::deque<Action> m_actions;
+  size_t m_n_applied;
+  size_t m_n_bytes;
+
+  Rect get_tile_rect(unsigned int i_tile) const;
+  std::shared_ptr<const Tile> copy_tile(unsigned int i_tile) const;
+  void paste_tile(unsigned int i_tile, const Tile& tile);
+  void evict();
+  static size_t get_n_bytes(const Action& action, bool is_before);
+};
+
+#endif // UNDO_HISTORY_HPP
@@ -0,0 +1,36 @@
+#ifndef COLOR_GRADING_HPP
+#define COLOR_GRADING_HPP
+
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "glad/glad.h"
+#include "render/renderer.hpp"
+#include "texture/texture_2d.hpp"
+#include "texture/texture_volume.hpp"
+
+/* Grading operation on a color with components in [0, 1] (e.g. exposure, contrast, saturation, curves) */
+using ColorTransform = std::function<glm::vec3(const glm::vec3&)>;
+
+/**
+ * Post-processing pass applying a chain of color transforms baked into a 3D LUT
+ * Chain evaluated on the cpu only when it changes, grading then costs one texture fetch per pixel
+ * https://developer.nvidia.com/gpugems/gpugems2/part-iii-high-quality-rendering/chapter-24-using-lookup-tables-accelerate-color
+ */
+struct ColorGrading {
+  ColorGrading(int lut_size=32, GLenum index_lut=GL_TEXTURE1);
+  void set_chain(const std::vector<ColorTransform>& chain);
+  void apply(const Texture2D& texture_color);
+  void free();
+
+private:
+  int m_lut_size;
+  TextureVolume m_lut;
+  Renderer m_renderer;
+
+  static const std::string SOURCE_VERTEX;
+  static const std::string SOURCE_FRAGMENT;
+};
+
+#endif // COLOR_GRADING_HPP
@@ -0,0 +1,56 @@
+#ifndef PICKING_PASS_HPP
+#define PICKING_PASS_HPP
+
+#include <string>
+
+#include "glad/glad.h"
+#include "render/renderer.hpp"
+#include "texture/texture_2d.hpp"
+#include "framebuffer/framebuffer.hpp"
+#include "framebuffer/async_readback.hpp"
+
+/* Object & instance under the cursor */
+struct Pick {
+  bool is_hit;
+  unsigned int object_id;
+  unsigned int instance;
+};
+
+/**
+ * Offscreen pass rendering `object_id << 16 | instance` of each pixel into an integer (GL_R32UI) attachment
+ * Renderers are drawn with their own geometry & transforms but a minimal id shader,
+ * pixels around the cursor are read back asynchronously (pick available a few frames later, without stalling)
+ * Object ids start at 1 (0 = background), instances (`gl_InstanceID`) are limited to 16 bits
+ */
+struct PickingPass {
+  PickingPass(int width, int height, unsigned int n_instances_max=64);
+  void begin();
+  void draw(Renderer& renderer, unsigned int object_id);
+  void end();
+  void request(int x, int y, int radius=2);
+  bool get_pick(Pick& pick);
+  void free();
+
+private:
+  Texture2D m_texture;
+  Framebuffer m_framebuffer;
+  Program m_program;
+  AsyncReadback m_readback;
+
+  /* last requested pick (older ones superseded) */
+  ReadbackHandle m_handle;
+  int m_x;
+  int m_y;
+
+  /* size of `models` array in id shader */
+  unsigned int m_n_instances_max;
+
+  /* state restored at the end of the pass */
+  GLint m_viewport[4];
+  GLboolean m_is_depth_test;
+
+  static std::string get_source_vertex(unsigned int n_instances_max);
+  static const std::string SOURCE_FRAGMENT;
+};
+
+#endif // PICKING_PASS_HPP
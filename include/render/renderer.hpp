@@ -20,9 +20,11 @@ struct Renderer {
   Program program;
 
   Renderer(const Program& pgm, const Geometry& geometry, const std::vector<Attribute>& attributes, bool is_text=false);
+  Renderer(const Program& pgm, const VBO& v, const std::vector<Attribute>& attributes);
   virtual void free() final;
 
   void set_transform(const Transformation& transform);
+  GLsizei get_n_instances() const;
 
   void draw(const Uniforms& u);
   void draw_plane(const Uniforms& u);
@@ -39,6 +41,7 @@ private:
   GLsizei m_n_instances;
 
   void _draw(const Uniforms& u, GLenum mode, unsigned int n_elements=0, size_t offset=0);
+  void set_attributes(const std::vector<Attribute>& attributes);
 };
 
 #endif // RENDERER_HPP
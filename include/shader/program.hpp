@@ -12,6 +12,7 @@ struct Program {
   GLuint id;
 
   Program(const std::string& path_vertex, const std::string& path_fragment);
+  static Program from_sources(const std::string& source_vertex, const std::string& source_fragment);
   void use();
   void unuse();
   void free();
@@ -20,6 +21,9 @@ struct Program {
   void set_uniforms(const Uniforms& uniforms);
 
 private:
+  Program();
+  void link(const std::string& source_vertex, const std::string& source_fragment);
+
   void set_bool(const std::string& name, bool value);
   void set_int(const std::string& name, int value);
   void set_float(const std::string& name, float value);
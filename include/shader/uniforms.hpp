@@ -8,6 +8,8 @@
 
 #include "texture/texture_2d.hpp"
 #include "texture/texture_3d.hpp"
+#include "texture/texture_2d_array.hpp"
+#include "texture/texture_volume.hpp"
 
 // dictionary type for heteregenous uniform values
 using KeyUniform = std::string;
@@ -19,7 +21,9 @@ using ValueUniform = std::variant<
   glm::vec3,
   glm::mat4,
   Texture2D,
-  Texture3D
+  Texture3D,
+  Texture2DArray,
+  TextureVolume
 >;
 using Uniforms = std::unordered_map<KeyUniform, ValueUniform>;
 
@@ -0,0 +1,25 @@
+#ifndef BRICK_SOURCE_HPP
+#define BRICK_SOURCE_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * Interface to a volume too large to be loaded at once, divided in cubic bricks
+ * Implemented by calling code (bricks read from disk, generated procedurally...)
+ */
+struct BrickSource {
+  /* Edge in voxels of a brick (same for all bricks) */
+  virtual unsigned int get_brick_size() const = 0;
+  virtual int get_n_channels() const = 0;
+
+  /* # of bricks along x, y & z */
+  virtual glm::uvec3 get_n_bricks() const = 0;
+
+  /* Voxels of a full brick (x varying fastest, then y, then z) */
+  virtual std::vector<unsigned char> get_brick(const glm::uvec3& brick) = 0;
+
+  virtual ~BrickSource() = default;
+};
+
+#endif // BRICK_SOURCE_HPP
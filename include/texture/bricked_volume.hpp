@@ -0,0 +1,49 @@
+#ifndef BRICKED_VOLUME_HPP
+#define BRICKED_VOLUME_HPP
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "glad/glad.h"
+#include "texture_volume.hpp"
+#include "brick_source.hpp"
+#include "page_manager.hpp"
+
+/**
+ * Streamed volume: only bricks requested by calling code are resident (3D counterpart of `VirtualTexture`)
+ * Sampling in glsl (indirection with nearest filtering, pool with linear filtering):
+ *   vec4 entry = texture(indirection, uvw);
+ *   vec3 uvw_brick = fract(uvw * textureSize(indirection, 0));
+ *   vec3 uvw_pool = (entry.rgb * 255.0 + uvw_brick) / n_bricks_side; // entry.a = 0 => brick not resident
+ */
+struct BrickedVolume {
+  /* physical pool of n_bricks_side^3 bricks */
+  TextureVolume pool;
+
+  /* one texel per virtual brick (rgb = brick position in pool, a = residency) */
+  TextureVolume indirection;
+
+  BrickedVolume(BrickSource& source, unsigned int n_bricks_side, unsigned int n_uploads_max=8,
+                GLenum index_pool=GL_TEXTURE0, GLenum index_indirection=GL_TEXTURE1);
+  void request(const glm::uvec3& brick);
+  void update();
+  void free();
+
+private:
+  BrickSource& m_source;
+  PageManager m_page_manager;
+  unsigned int m_n_bricks_side;
+  unsigned int m_n_uploads_max;
+
+  /* bricks requested in current frame (deduplicated) */
+  std::vector<glm::uvec3> m_requests;
+  std::unordered_set<uint64_t> m_keys_requested;
+
+  static uint64_t get_key(const glm::uvec3& brick);
+  static glm::uvec3 get_brick(uint64_t key);
+  void set_indirection_entry(const glm::uvec3& brick, unsigned int slot, bool is_resident);
+};
+
+#endif // BRICKED_VOLUME_HPP
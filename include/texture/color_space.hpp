@@ -0,0 +1,20 @@
+#ifndef COLOR_SPACE_HPP
+#define COLOR_SPACE_HPP
+
+#include <vector>
+
+#include "image.hpp"
+
+/**
+ * Conversions between sRGB-encoded 8-bits colors & linear float colors for cpu-side image processing
+ * Table lookups (no `pow()` per channel), alpha channel left linear
+ * https://en.wikipedia.org/wiki/SRGB#Transformation
+ */
+namespace ColorSpace {
+  float srgb_to_linear(unsigned char value);
+  unsigned char linear_to_srgb(float value);
+  std::vector<float> to_linear(const Image& image);
+  void to_srgb(const std::vector<float>& values, Image& image);
+};
+
+#endif // COLOR_SPACE_HPP
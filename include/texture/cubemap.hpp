@@ -0,0 +1,15 @@
+#ifndef CUBEMAP_HPP
+#define CUBEMAP_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "image.hpp"
+
+/* Cpu-side helpers for cubemap faces (ordered like GL_TEXTURE_CUBE_MAP_POSITIVE_X + i) */
+namespace Cubemap {
+  glm::vec3 get_direction(int i_face, float s, float t);
+  std::vector<Image> from_equirectangular(const Image& image, int size);
+};
+
+#endif // CUBEMAP_HPP
@@ -0,0 +1,36 @@
+#ifndef DIRTY_REGION_HPP
+#define DIRTY_REGION_HPP
+
+#include <vector>
+
+#include "texture/image.hpp"
+#include "texture/rect.hpp"
+#include "texture/texture_2d.hpp"
+
+/**
+ * Tracks rectangles modified in a cpu image & uploads them to its texture once per frame
+ * Avoids a bind/upload/unbind per brush stamp in <imgui-paint>:
+ *   painting code calls `add()` after each stamp, render loop calls `flush()`
+ * Image is only viewed (not freed), texture copy shares the opengl id of the original one
+ */
+struct DirtyRegion {
+  DirtyRegion(const Texture2D& texture, const Image& image, unsigned int max_rects=16);
+  void add(const Rect& rect);
+  void flush();
+  void clear();
+  bool is_empty() const;
+  const std::vector<Rect>& get_rects() const;
+
+private:
+  Texture2D m_texture;
+  Image m_image;
+  unsigned int m_max_rects;
+
+  /* disjoint-ish rectangles (only pairs not worth merging are kept apart) */
+  std::vector<Rect> m_rects;
+
+  static long get_merge_cost(const Rect& rect1, const Rect& rect2);
+  void merge_cheapest();
+};
+
+#endif // DIRTY_REGION_HPP
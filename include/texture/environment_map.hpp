@@ -0,0 +1,52 @@
+#ifndef ENVIRONMENT_MAP_HPP
+#define ENVIRONMENT_MAP_HPP
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "glad/glad.h"
+#include "image.hpp"
+#include "texture_3d.hpp"
+
+/**
+ * Prefiltered environment for image-based lighting (split-sum approximation):
+ *   - diffuse irradiance cubemap: cosine-weighted convolution of environment (sampled along normal)
+ *   - specular cubemap whose mip level i is convolved with GGX lobe of roughness i / (n_levels - 1)
+ * Computed once on the cpu (in parallel) & cached to disk as KTX files, so shading needs only 2 lookups
+ * https://learnopengl.com/PBR/IBL/Specular-IBL
+ */
+struct EnvironmentMap {
+  /* 6 faces of irradiance cubemap */
+  std::vector<Image> irradiance;
+
+  /* 6 faces for each mip level of specular cubemap (finest first) */
+  std::vector<std::vector<Image>> specular;
+
+  EnvironmentMap(Texture3D& source, int size_irradiance=32, int size_specular=128, int n_levels=5, int n_samples=128);
+  EnvironmentMap(const std::string& path_prefix);
+
+  static bool is_cached(const std::string& path_prefix);
+  void save(const std::string& path_prefix) const;
+  Texture3D get_irradiance_texture(GLenum index=GL_TEXTURE0);
+  Texture3D get_specular_texture(GLenum index=GL_TEXTURE0);
+  void free();
+
+private:
+  /* linear-space rgb faces of a mip level of the source */
+  struct Level {
+    int size;
+    std::vector<std::vector<glm::vec3>> faces;
+  };
+
+  /* source mip chain (finest first) */
+  std::vector<Level> m_levels;
+
+  void set_levels(Texture3D& source);
+  glm::vec3 sample(const glm::vec3& direction, float level) const;
+  glm::vec3 sample_level(const glm::vec3& direction, int level) const;
+  glm::vec3 convolve_irradiance(const glm::vec3& normal, int n_samples) const;
+  glm::vec3 convolve_specular(const glm::vec3& normal, float roughness, int n_samples) const;
+};
+
+#endif // ENVIRONMENT_MAP_HPP
@@ -0,0 +1,45 @@
+#ifndef FEEDBACK_PASS_HPP
+#define FEEDBACK_PASS_HPP
+
+#include <vector>
+
+#include "glad/glad.h"
+#include "texture_2d.hpp"
+#include "framebuffer/framebuffer.hpp"
+#include "framebuffer/pixel_buffer.hpp"
+
+/* Mip level of a streamed texture needed by at least one pixel on screen */
+struct FeedbackRequest {
+  unsigned int id;
+  int level;
+};
+
+/**
+ * Low-resolution render pass recording which streamed texture & mip level each pixel samples
+ * Fragment shader writes rgba8 = (id & 0xff, id >> 8, mip level, 1) with mip level computed from full-res texture size:
+ *   vec2 texels = uv * texture_size;
+ *   float level = log2(max(length(dFdx(texels)), length(dFdy(texels)))) - log2(feedback_scale);
+ *   color = vec4(id % 256, id / 256, max(level, 0.0), 255.0) / 255.0;
+ * Read back asynchronously (results available a couple of frames later, without stalling)
+ */
+struct FeedbackPass {
+  FeedbackPass(int width, int height);
+  void begin();
+  void end();
+  bool get_requests(std::vector<FeedbackRequest>& requests);
+  void free();
+
+private:
+  Framebuffer m_framebuffer;
+  Texture2D m_texture;
+
+  /* readbacks in flight (used as a ring) */
+  std::vector<PixelBuffer> m_buffers;
+  size_t m_i_read;
+  size_t m_i_write;
+
+  /* viewport restored at the end of the pass */
+  GLint m_viewport[4];
+};
+
+#endif // FEEDBACK_PASS_HPP
@@ -13,7 +13,7 @@ struct Image {
   std::string path;
 
   Image();
-  Image(const std::string& p, bool flip=true);
+  Image(const std::string& p, bool flip=true, int desired_channels=0);
   Image(int w, int h, int n, unsigned char* ptr, bool needs_free=true);
   void free() const;
 
@@ -0,0 +1,67 @@
+#ifndef IMAGE_CACHE_HPP
+#define IMAGE_CACHE_HPP
+
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "image.hpp"
+
+/**
+ * Process-wide cache of decoded images (avoids re-reading & re-decoding same path in different renderers)
+ * Thread-safe, images shared with calling code & freed once neither the cache nor the caller hold them
+ * Images handed out don't own their data (`Image::free()` is a no-op, so they can be given to `Texture2D`)
+ */
+struct ImageCache {
+  static ImageCache& get();
+
+  std::shared_ptr<const Image> load(const std::string& path, bool flip=true, int desired_channels=0);
+  void set_budget(size_t n_bytes_budget);
+  void clear();
+
+  size_t get_n_bytes() const;
+  size_t get_n_hits() const;
+  size_t get_n_misses() const;
+
+private:
+  struct Key {
+    std::string path;
+    bool flip;
+    int desired_channels;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<const Image> image;
+    std::filesystem::file_time_type time_modified;
+    size_t n_bytes;
+    std::list<Key>::iterator it_lru;
+  };
+
+  /* guards all members below (decoding done outside the lock) */
+  mutable std::mutex m_mutex;
+
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+
+  /* most recently used images at the front */
+  std::list<Key> m_lru;
+
+  size_t m_n_bytes_budget;
+  size_t m_n_bytes;
+  size_t m_n_hits;
+  size_t m_n_misses;
+
+  ImageCache(size_t n_bytes_budget);
+  void erase(const Key& key);
+  void evict();
+};
+
+#endif // IMAGE_CACHE_HPP
@@ -0,0 +1,20 @@
+#ifndef IMAGE_HASH_HPP
+#define IMAGE_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "image.hpp"
+
+/**
+ * Fast non-cryptographic hash of image content (not of its path)
+ * 4 interleaved 32-bits lanes (vectorized with SSE2 when available) mixed into 64 bits
+ */
+namespace ImageHash {
+  uint64_t get(const unsigned char* data, size_t n_bytes);
+  uint64_t get(const Image& image);
+  uint64_t combine(const std::vector<uint64_t>& hashes);
+}
+
+#endif // IMAGE_HASH_HPP
@@ -0,0 +1,40 @@
+#ifndef IMAGE_LOADER_HPP
+#define IMAGE_LOADER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image.hpp"
+
+/* Decoded image, available once decoded in the background */
+using FutureImage = std::shared_future<std::shared_ptr<const Image>>;
+
+/**
+ * Pool of threads decoding images in the background (through `ImageCache`)
+ * Only decoding is done here, upload to the gpu has to happen on the thread owning the GL context
+ */
+struct ImageLoader {
+  static ImageLoader& get();
+
+  FutureImage load(const std::string& path, bool flip=true, int desired_channels=0);
+  ~ImageLoader();
+
+private:
+  std::vector<std::thread> m_threads;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_is_stopped;
+
+  ImageLoader(unsigned int n_threads);
+  void run();
+};
+
+#endif // IMAGE_LOADER_HPP
@@ -0,0 +1,19 @@
+#ifndef KTX_HPP
+#define KTX_HPP
+
+#include <string>
+#include <vector>
+
+#include "image.hpp"
+
+/**
+ * Reader/writer for KTX 1.1 containers of 8-bits textures (gpu-ready: uploaded without any decoding)
+ * Levels stored finest first, each with 1 image (2D texture) or 6 faces (cubemap)
+ * https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html
+ */
+namespace Ktx {
+  void save(const std::string& path, const std::vector<std::vector<Image>>& levels, bool is_srgb=false);
+  std::vector<std::vector<Image>> load(const std::string& path);
+};
+
+#endif // KTX_HPP
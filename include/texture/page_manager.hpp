@@ -0,0 +1,52 @@
+#ifndef PAGE_MANAGER_HPP
+#define PAGE_MANAGER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/* Result of `PageManager::acquire()` */
+struct PageSlot {
+  unsigned int slot;
+
+  /* page wasn't resident => content needs to be uploaded */
+  bool is_new;
+
+  /* least-recently used page whose slot was reused */
+  bool has_evicted;
+  uint64_t key_evicted;
+};
+
+/**
+ * Assigns a fixed # of slots (e.g. pages in a physical texture cache) to pages identified by a key
+ * Least-recently used page is evicted when all slots are occupied
+ * No GL calls, only bookkeeping (used by `VirtualTexture` & `BrickedVolume`)
+ */
+struct PageManager {
+  PageManager(unsigned int n_slots);
+  PageSlot acquire(uint64_t key);
+  void load_missing(const std::vector<uint64_t>& keys, unsigned int n_loads_max,
+                    const std::function<void(uint64_t key, const PageSlot& page_slot)>& load);
+  bool touch(uint64_t key);
+  bool is_resident(uint64_t key) const;
+  void release(uint64_t key);
+  unsigned int get_n_resident() const;
+  unsigned int get_n_slots() const;
+
+private:
+  struct Entry {
+    unsigned int slot;
+    std::list<uint64_t>::iterator it_lru;
+  };
+
+  unsigned int m_n_slots;
+
+  /* most recently used pages at the front */
+  std::list<uint64_t> m_lru;
+  std::unordered_map<uint64_t, Entry> m_entries;
+  std::vector<unsigned int> m_free_slots;
+};
+
+#endif // PAGE_MANAGER_HPP
@@ -0,0 +1,33 @@
+#ifndef PIXEL_STORE_HPP
+#define PIXEL_STORE_HPP
+
+#include <cstddef>
+
+#include "glad/glad.h"
+
+/**
+ * Pixel pack (gpu -> cpu) or unpack (cpu -> gpu) parameters changed for a transfer, then restored with `restore()`
+ * Previous values kept instead of reset to defaults, as calling code can rely on its own
+ * (e.g. GL_UNPACK_ALIGNMENT of 1 for font bitmaps)
+ * Rows start at beginning of data & aren't longer than transferred width until `set_rect()`
+ */
+struct PixelStore {
+  PixelStore(bool is_pack);
+  void set_alignment(GLint alignment);
+  void set_rect(GLint row_length, GLint skip_pixels, GLint skip_rows);
+  void restore() const;
+  static GLint get_alignment(size_t n_bytes_row);
+
+private:
+  bool m_is_pack;
+
+  /* values before the transfer */
+  GLint m_alignment;
+  GLint m_row_length;
+  GLint m_skip_pixels;
+  GLint m_skip_rows;
+
+  GLenum get_name(GLenum name_pack, GLenum name_unpack) const;
+};
+
+#endif // PIXEL_STORE_HPP
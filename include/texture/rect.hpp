@@ -0,0 +1,22 @@
+#ifndef RECT_HPP
+#define RECT_HPP
+
+/* Axis-aligned rectangle of pixels in an image (e.g. region modified by a brush stamp in <imgui-paint>) */
+struct Rect {
+  int x;
+  int y;
+  int width;
+  int height;
+
+  Rect();
+  Rect(int x, int y, int w, int h);
+
+  bool is_empty() const;
+  long area() const;
+  bool touches(const Rect& other) const;
+  Rect merge(const Rect& other) const;
+  Rect intersect(const Rect& other) const;
+  Rect clip(int w, int h) const;
+};
+
+#endif // RECT_HPP
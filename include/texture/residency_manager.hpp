@@ -0,0 +1,63 @@
+#ifndef RESIDENCY_MANAGER_HPP
+#define RESIDENCY_MANAGER_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glad/glad.h"
+#include "texture.hpp"
+
+/**
+ * Keeps gpu memory used by registered textures under a budget
+ * Least-recently attached textures are evicted (content copied to cpu or disk, storage released),
+ * then reloaded transparently in their next `Texture::attach()`
+ * Texture id is kept on eviction, so copies of a texture (e.g. in `Uniforms`) remain valid
+ */
+struct ResidencyManager {
+  ResidencyManager(size_t n_bytes_budget, const std::string& dir_spill="");
+  void add(Texture& texture);
+  void remove(const Texture& texture);
+  void update(Texture& texture);
+  void touch(const Texture& texture);
+  void next_frame();
+  bool is_resident(const Texture& texture) const;
+  size_t get_n_bytes() const;
+  void set_budget(size_t n_bytes_budget);
+
+private:
+  /* copy of a mip level (or of a cubemap face's level) */
+  struct Level {
+    GLenum target;
+    GLint level;
+    GLint internal_format;
+    GLsizei width;
+    GLsizei height;
+    GLsizei depth;
+    std::vector<unsigned char> data;
+  };
+
+  struct Entry {
+    GLuint id;
+    GLenum type;
+    GLenum format;
+    size_t n_bytes;
+    unsigned int frame_last_used;
+    bool is_resident;
+    std::vector<Level> levels;
+  };
+
+  std::unordered_map<GLuint, Entry> m_entries;
+  size_t m_n_bytes_budget;
+  size_t m_n_bytes;
+  unsigned int m_i_frame;
+
+  /* evicted textures written to this directory instead of kept in ram (if not empty) */
+  std::string m_dir_spill;
+
+  void evict(Entry& entry);
+  void reload(Entry& entry);
+  std::string get_path_spill(GLuint id) const;
+};
+
+#endif // RESIDENCY_MANAGER_HPP
@@ -0,0 +1,59 @@
+#ifndef STREAMING_MANAGER_HPP
+#define STREAMING_MANAGER_HPP
+
+#include <functional>
+#include <vector>
+
+#include "glad/glad.h"
+#include "image.hpp"
+#include "wrapping.hpp"
+#include "texture_2d.hpp"
+#include "feedback_pass.hpp"
+
+/* Loads given mip level of a streamed texture (level 0 = full resolution) */
+using LevelLoader = std::function<Image(int level)>;
+
+/**
+ * Keeps streamed textures resident only down to the mip levels visible on screen (according to `FeedbackPass`)
+ * Coarsest level always resident, finer levels uploaded progressively (one per texture per update)
+ * & evicted once no longer requested
+ */
+struct StreamingManager {
+  StreamingManager(unsigned int n_uploads_max=4, unsigned int n_updates_unused=60);
+  unsigned int add(const LevelLoader& load_level, int n_levels, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT);
+  Texture2D get_texture(unsigned int id) const;
+  void update(const std::vector<FeedbackRequest>& requests);
+  size_t get_n_bytes() const;
+  void free();
+
+private:
+  struct Entry {
+    Texture2D texture;
+    LevelLoader load_level;
+    int n_levels;
+
+    /* finest level resident & finest level requested by feedback */
+    int level_resident;
+    int level_desired;
+
+    unsigned int update_last_requested;
+    std::vector<size_t> n_bytes_levels;
+  };
+
+  /* texture id written by feedback shader = index in vector + 1 (0 = background) */
+  std::vector<Entry> m_entries;
+
+  /* budget of levels uploaded per update */
+  unsigned int m_n_uploads_max;
+
+  /* textures not requested for that many updates fall back to their coarsest level */
+  unsigned int m_n_updates_unused;
+
+  unsigned int m_i_update;
+  size_t m_n_bytes;
+
+  void load_finer_level(Entry& entry);
+  void evict_finest_level(Entry& entry);
+};
+
+#endif // STREAMING_MANAGER_HPP
@@ -8,6 +8,8 @@
 #include "glad/glad.h"
 #include "wrapping.hpp"
 
+struct ResidencyManager;
+
 /* Abstract class (cannot be instantiated) */
 struct Texture {
   /* Needed in `Framebuffer` class */
@@ -19,10 +21,22 @@ struct Texture {
   std::string name;
 
   GLenum get_index() const;
-  void attach();
+  void set_index(GLenum index);
+  /* virtual so lazy textures are uploaded even when attached through a `Texture&` */
+  virtual void attach();
   int get_n_channels() const;
+  bool is_srgb() const;
+  void generate_mipmaps();
+  void set_filters(GLint filter_min, GLint filter_mag);
+  void set_levels_range(GLint level_base, GLint level_max);
+  size_t get_n_bytes();
+  static GLint get_n_levels_max(GLenum type);
+  static size_t get_n_bytes_texel(GLint internal_format);
   void free() const;
 
+  /* Notified of each `attach()` when set by calling code (reloads evicted textures) */
+  static ResidencyManager* residency_manager;
+
   /**
    * Virtual dtor required in polymorphic base class, otherwise derived class' dtor not called in:
    * Texture *tex = new Texture2D(); delete tex; // clang throws a warning
@@ -36,6 +50,12 @@ protected:
   /* whether texture is repeated, stretched or set to black beyond [0, 1] */
   Wrapping m_wrapping;
 
+  /* colors stored in sRGB space (decoded to linear by hardware when sampled) */
+  bool m_is_srgb;
+
+  /* sized format of texels on the gpu (can differ from `format` of uploaded pixels) */
+  GLint m_internal_format;
+
   void generate();
   void configure();
   void bind();
@@ -47,7 +67,7 @@ protected:
    * Default ctor mandatory for derived class Texture2D's default ctor
    */
   Texture();
-  Texture(GLuint t, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, const std::string& path="");
+  Texture(GLuint t, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, const std::string& path="", bool is_srgb=false);
 };
 
 #endif // TEXTURE_HPP
@@ -1,9 +1,13 @@
 #ifndef TEXTURE_2D_HPP
 #define TEXTURE_2D_HPP
 
+#include <memory>
+
 #include "glad/glad.h"
 
 #include "image.hpp"
+#include "image_loader.hpp"
+#include "rect.hpp"
 #include "wrapping.hpp"
 #include "texture.hpp"
 
@@ -17,11 +21,42 @@ struct Texture2D : Texture {
    * also by LevelRenderer::m_textures & FloorsRenderer::m_textures (i.e. map::operator[]())
    */
   Texture2D() = default;
-  Texture2D(const Image& img, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT);
+  Texture2D(const Image& img, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_srgb=false);
+  Texture2D(int w, int h, GLint internal_format, GLenum format_pixels, GLenum type_pixels, GLenum index=GL_TEXTURE0);
+
+  static Texture2D from_path(const std::string& path, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_async=true, bool flip=true, bool is_srgb=false);
+  static Texture2D from_level(const Image& img, GLint level, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT);
+
+  void attach() override;
+  bool is_loaded() const;
+  void load();
 
   void set_image(const Image& image);
   void set_subimage(const Image& subimage, const glm::uvec2& size, const glm::uvec2& offset);
+  void set_subimage(const Image& image, const Rect& rect);
+  void set_subimages(const Image& image, const std::vector<Rect>& rects);
   Image get_image();
+
+  void set_level(const Image& image, GLint level);
+  void free_level(GLint level);
+
+private:
+  /* Source of a lazy texture (shared by its copies, e.g. in `Uniforms`, so it's uploaded only once) */
+  struct LazySource {
+    std::string path;
+    bool flip;
+    bool is_async;
+    bool is_loaded;
+    FutureImage image;
+    int width;
+    int height;
+  };
+
+  std::shared_ptr<LazySource> m_source;
+
+  Texture2D(GLenum index, Wrapping wrapping, const std::string& path, bool is_srgb=false);
+  void upload_source();
+  void upload_rect(const Image& image, const Rect& rect);
 };
 
 #endif // TEXTURE_2D_HPP
@@ -0,0 +1,32 @@
+#ifndef TEXTURE_2D_ARRAY_HPP
+#define TEXTURE_2D_ARRAY_HPP
+
+#include <vector>
+
+#include "glad/glad.h"
+#include "image.hpp"
+#include "wrapping.hpp"
+#include "texture.hpp"
+
+/**
+ * Stack of same-sized 2D images sampled in glsl with `sampler2DArray` & uvw-coords (w = layer index)
+ * Allows tiles/terrain textures to be bound on a single texture unit (less binds & merged draw calls)
+ */
+struct Texture2DArray : Texture {
+  int width;
+  int height;
+  int n_layers;
+
+  /* Default ctor needed by `std::variant` in `Uniforms` */
+  Texture2DArray() = default;
+  Texture2DArray(const std::vector<Image>& images, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool has_mipmaps=false);
+
+  void set_layer(const Image& image, int i_layer);
+
+private:
+  bool m_has_mipmaps;
+
+  void from_images(const std::vector<Image>& images);
+};
+
+#endif // TEXTURE_2D_ARRAY_HPP
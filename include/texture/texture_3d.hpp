@@ -9,8 +9,14 @@
 #include "texture.hpp"
 
 struct Texture3D : Texture {
-  Texture3D(const std::vector<Image>& images, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_same_image=false);
-  Texture3D(const Image& image, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT);
+  Texture3D(const std::vector<Image>& images, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_same_image=false, bool is_srgb=false);
+  Texture3D(const Image& image, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_srgb=false);
+
+  static Texture3D from_equirectangular(const Image& image, int size, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::STRETCH);
+  static Texture3D from_levels(const std::vector<std::vector<Image>>& levels, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::STRETCH, bool is_srgb=false);
+
+  void set_level(const std::vector<Image>& images, GLint level);
+  std::vector<Image> get_images(GLint level=0);
 
 private:
   /* Same image data ptr. on all 6 faces (avoids double-free) */
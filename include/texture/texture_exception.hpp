@@ -0,0 +1,16 @@
+#ifndef TEXTURE_EXCEPTION_HPP
+#define TEXTURE_EXCEPTION_HPP
+
+#include <exception>
+#include <string>
+
+class TextureException : public std::exception {
+  public:
+    TextureException(const std::string& message);
+    const char* what() const noexcept override;
+
+  private:
+    std::string m_message;
+};
+
+#endif // TEXTURE_EXCEPTION_HPP
@@ -0,0 +1,60 @@
+#ifndef TEXTURE_REGISTRY_HPP
+#define TEXTURE_REGISTRY_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "glad/glad.h"
+#include "image.hpp"
+#include "wrapping.hpp"
+#include "texture_2d.hpp"
+#include "texture_3d.hpp"
+
+/**
+ * Deduplicates textures by image content (identical pixels under different paths uploaded only once)
+ * Returned textures share the same gpu texture, which is deleted once all of them are released
+ * Given images are freed in all cases (like in `Texture2D` & `Texture3D` ctors)
+ */
+struct TextureRegistry {
+  Texture2D get_texture_2d(const Image& image, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_srgb=false);
+  Texture3D get_texture_3d(const std::vector<Image>& images, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_srgb=false);
+  Texture3D get_texture_3d(const Image& image, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::REPEAT, bool is_srgb=false);
+  void release(const Texture& texture);
+  size_t get_n_textures() const;
+  size_t get_n_duplicates() const;
+  void free();
+
+private:
+  /* images are freed once uploaded, so dimensions are compared in addition to the content's hash */
+  struct Key {
+    uint64_t hash;
+    GLuint type;
+    Wrapping wrapping;
+    bool is_srgb;
+    int width;
+    int height;
+    int n_channels;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  /* Texture3D has no default ctor (can't be used with `map::operator[]()`) */
+  std::unordered_map<Key, Texture2D, KeyHash> m_textures_2d;
+  std::unordered_map<Key, Texture3D, KeyHash> m_textures_3d;
+
+  /* # of textures handed out for each gpu texture */
+  std::unordered_map<GLuint, unsigned int> m_n_refs;
+  std::unordered_map<GLuint, Key> m_keys;
+
+  /* uploads avoided */
+  size_t m_n_duplicates = 0;
+
+  Texture3D get_texture_3d(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool is_srgb, bool is_same_image);
+};
+
+#endif // TEXTURE_REGISTRY_HPP
@@ -0,0 +1,35 @@
+#ifndef TEXTURE_VOLUME_HPP
+#define TEXTURE_VOLUME_HPP
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "glad/glad.h"
+#include "image.hpp"
+#include "wrapping.hpp"
+#include "texture.hpp"
+
+/**
+ * Volumetric texture (GL_TEXTURE_3D) sampled in glsl with `sampler3D` & uvw-coords
+ * Not to be confused with `Texture3D` (a cubemap)
+ * Used for fog densities, color-grading LUTs & voxel data
+ * Divided in bricks of `brick_size`^3 voxels which can be updated individually
+ */
+struct TextureVolume : Texture {
+  glm::uvec3 size;
+  unsigned int brick_size;
+
+  /* Default ctor needed by `std::variant` in `Uniforms` */
+  TextureVolume() = default;
+  TextureVolume(const std::vector<Image>& slices, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::STRETCH, unsigned int brick_sz=32);
+  TextureVolume(const glm::uvec3& sz, int n_channels, const unsigned char* data, GLenum index=GL_TEXTURE0, Wrapping wrapping=Wrapping::STRETCH, unsigned int brick_sz=32);
+
+  glm::uvec3 get_n_bricks() const;
+  void set_region(const unsigned char* data, const glm::uvec3& sz, const glm::uvec3& offset);
+  void set_brick(const unsigned char* data, const glm::uvec3& brick);
+
+private:
+  void allocate(int n_channels, const unsigned char* data);
+};
+
+#endif // TEXTURE_VOLUME_HPP
@@ -0,0 +1,26 @@
+#ifndef TILE_SOURCE_HPP
+#define TILE_SOURCE_HPP
+
+#include <glm/glm.hpp>
+
+#include "image.hpp"
+
+/**
+ * Interface to a tiled image too large to be loaded at once (e.g. terrain or gigapixel canvas)
+ * Implemented by calling code (tiles read from disk, decoded from an archive, generated...)
+ */
+struct TileSource {
+  /* Size in pixels of a square tile (same for all tiles) */
+  virtual int get_tile_size() const = 0;
+  virtual int get_n_channels() const = 0;
+
+  /* # of tiles along x & y */
+  virtual glm::uvec2 get_n_tiles() const = 0;
+
+  /* Image pointer is freed by the caller after upload */
+  virtual Image get_tile(const glm::uvec2& tile) = 0;
+
+  virtual ~TileSource() = default;
+};
+
+#endif // TILE_SOURCE_HPP
@@ -0,0 +1,52 @@
+#ifndef VIRTUAL_TEXTURE_HPP
+#define VIRTUAL_TEXTURE_HPP
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "glad/glad.h"
+#include "texture_2d.hpp"
+#include "tile_source.hpp"
+#include "page_manager.hpp"
+
+/**
+ * Sparse virtual texture: only the pages (tiles) requested by calling code are resident on the gpu
+ * VRAM use is fixed by the size of the physical cache, whatever the size of the tiled source
+ * Sampling in glsl (page table with nearest filtering, cache with linear filtering):
+ *   vec4 entry = texture(page_table, uv);
+ *   vec2 uv_page = fract(uv * textureSize(page_table, 0));
+ *   vec2 uv_cache = (entry.rg * 255.0 + uv_page) / n_pages_side; // entry.a = 0 => page not resident
+ */
+struct VirtualTexture {
+  /* physical cache of n_pages_side x n_pages_side pages */
+  Texture2D cache;
+
+  /* indirection texture with one texel per virtual page (rg = page position in cache, a = residency) */
+  Texture2D page_table;
+
+  VirtualTexture(TileSource& source, unsigned int n_pages_side, unsigned int n_uploads_max=8,
+                 GLenum index_cache=GL_TEXTURE0, GLenum index_page_table=GL_TEXTURE1);
+  void request(const glm::uvec2& page);
+  void update();
+  void free();
+
+private:
+  TileSource& m_source;
+  PageManager m_page_manager;
+  unsigned int m_n_pages_side;
+
+  /* budget of pages loaded & uploaded per frame (avoids stutter when camera moves fast) */
+  unsigned int m_n_uploads_max;
+
+  /* pages requested in current frame (deduplicated) */
+  std::vector<glm::uvec2> m_requests;
+  std::unordered_set<uint64_t> m_keys_requested;
+
+  static uint64_t get_key(const glm::uvec2& page);
+  static glm::uvec2 get_page(uint64_t key);
+  void set_page_table_entry(const glm::uvec2& page, unsigned int slot, bool is_resident);
+};
+
+#endif // VIRTUAL_TEXTURE_HPP
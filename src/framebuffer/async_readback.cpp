@@ -0,0 +1,106 @@
+#include <cstring>
+
+#include "framebuffer/async_readback.hpp"
+
+/* @param n_buffers Initial # of pixel pack buffers (about # of reads per frame times frames of latency) */
+AsyncReadback::AsyncReadback(unsigned int n_buffers):
+  m_buffers(n_buffers)
+{
+  for (unsigned int i_buffer = 0; i_buffer < n_buffers; i_buffer++) {
+    m_free_buffers.push_back(n_buffers - 1 - i_buffer);
+  }
+}
+
+/* Pixel at (x, y) in framebuffer coords (origin at lower-left), e.g. under the cursor */
+ReadbackHandle AsyncReadback::read_pixel(const Framebuffer& framebuffer, int x, int y, GLenum format, GLenum type, const ReadbackCallback& callback) {
+  return read_rect(framebuffer, Rect(x, y, 1, 1), format, type, callback);
+}
+
+/**
+ * Queue copy of rectangle (clipped to framebuffer) from its color attachment
+ * @param format/type Pixel format & component type (e.g. GL_RED_INTEGER & GL_UNSIGNED_INT for an id buffer)
+ * @param callback Called by `update()` once pixels are available
+ */
+ReadbackHandle AsyncReadback::read_rect(const Framebuffer& framebuffer, const Rect& rect, GLenum format, GLenum type, const ReadbackCallback& callback) {
+  auto result = std::make_shared<ReadbackResult>();
+  result->rect = rect.clip(framebuffer.width, framebuffer.height);
+  result->format = format;
+  result->type = type;
+  result->is_ready = false;
+
+  if (result->rect.is_empty()) {
+    result->is_ready = true;
+    if (callback) {
+      callback(*result);
+    }
+    return result;
+  }
+
+  if (m_free_buffers.empty()) {
+    m_free_buffers.push_back(m_buffers.size());
+    m_buffers.emplace_back();
+  }
+
+  unsigned int i_buffer = m_free_buffers.back();
+  m_free_buffers.pop_back();
+
+  // unsupported format/type: delivered right away as an empty rectangle (nothing to wait for)
+  const Rect& region = result->rect;
+  if (!m_buffers[i_buffer].read(framebuffer, region.x, region.y, region.width, region.height, format, type)) {
+    m_free_buffers.push_back(i_buffer);
+    result->rect = Rect();
+    result->is_ready = true;
+    if (callback) {
+      callback(*result);
+    }
+    return result;
+  }
+
+  m_requests.push_back({ i_buffer, result, callback });
+
+  return result;
+}
+
+/* Whole color attachment (e.g. screenshot) */
+ReadbackHandle AsyncReadback::read_attachment(const Framebuffer& framebuffer, GLenum format, GLenum type, const ReadbackCallback& callback) {
+  return read_rect(framebuffer, Rect(0, 0, framebuffer.width, framebuffer.height), format, type, callback);
+}
+
+/**
+ * Deliver finished reads without blocking (called once per frame)
+ * Stops at first unfinished read as later ones were fenced after it
+ */
+void AsyncReadback::update() {
+  while (!m_requests.empty()) {
+    Request& request = m_requests.front();
+    PixelBuffer& buffer = m_buffers[request.i_buffer];
+    if (!buffer.is_ready()) {
+      break;
+    }
+
+    const unsigned char* pixels = buffer.map();
+    request.result->data.assign(pixels, pixels + buffer.get_n_bytes());
+    buffer.unmap();
+    request.result->is_ready = true;
+
+    if (request.callback) {
+      request.callback(*request.result);
+    }
+
+    m_free_buffers.push_back(request.i_buffer);
+    m_requests.pop_front();
+  }
+}
+
+unsigned int AsyncReadback::get_n_pending() const {
+  return m_requests.size();
+}
+
+/* Pending reads are dropped */
+void AsyncReadback::free() {
+  for (PixelBuffer& buffer : m_buffers) {
+    buffer.free();
+  }
+
+  m_requests.clear();
+}
@@ -0,0 +1,76 @@
+#include <cstring>
+
+#include "framebuffer/canvas_mirror.hpp"
+
+/**
+ * Whole framebuffer read back on first `update()`
+ * @param n_buffers Max # of readbacks in flight (one issued per frame at most)
+ */
+CanvasMirror::CanvasMirror(const Framebuffer& framebuffer, unsigned int n_buffers):
+  m_framebuffer(framebuffer),
+  m_format(framebuffer.n_channels == 4 ? GL_RGBA : framebuffer.n_channels == 3 ? GL_RGB : GL_RED),
+  m_data(static_cast<size_t>(framebuffer.width) * framebuffer.height * framebuffer.n_channels, 0),
+  m_readback(n_buffers),
+  m_max_pending(n_buffers),
+  m_dirty(0, 0, framebuffer.width, framebuffer.height)
+{
+}
+
+/* Region rendered into on the gpu (in framebuffer coords, i.e. origin at lower-left) */
+void CanvasMirror::mark_dirty(const Rect& rect) {
+  m_dirty = m_dirty.merge(rect.clip(m_framebuffer.width, m_framebuffer.height));
+}
+
+/**
+ * Called once per frame: copy finished readbacks to memory (oldest first), then read back region drawn since last call
+ * Never waits for the gpu: dirty region kept for next frame if all buffers are in flight
+ */
+void CanvasMirror::update() {
+  size_t n_bytes_pixel = m_framebuffer.n_channels;
+  m_readback.update();
+
+  while (!m_pending.empty() && m_pending.front()->is_ready) {
+    const ReadbackResult& result = *m_pending.front();
+    const Rect& rect = result.rect;
+    size_t n_bytes_row = rect.width * n_bytes_pixel;
+
+    for (int y = 0; y < rect.height; y++) {
+      size_t offset = (static_cast<size_t>(rect.y + y) * m_framebuffer.width + rect.x) * n_bytes_pixel;
+      std::memcpy(&m_data[offset], &result.data[y * n_bytes_row], n_bytes_row);
+    }
+
+    m_pending.pop_front();
+  }
+
+  if (m_dirty.is_empty() || m_pending.size() == m_max_pending) {
+    return;
+  }
+
+  m_pending.push_back(m_readback.read_rect(m_framebuffer, m_dirty, m_format));
+  m_dirty = Rect();
+}
+
+/* Nothing drawn that isn't in memory yet */
+bool CanvasMirror::is_synced() const {
+  return m_pending.empty() && m_dirty.is_empty();
+}
+
+/**
+ * Same as `Framebuffer::get_pixel_value()` but from memory (no gpu round trip)
+ * @param data Space for `n_channels` values allocated by calling code
+ */
+void CanvasMirror::get_pixel_value(int x, int y, unsigned char* data) const {
+  size_t n_bytes_pixel = m_framebuffer.n_channels;
+  std::memcpy(data, &m_data[(static_cast<size_t>(y) * m_framebuffer.width + x) * n_bytes_pixel], n_bytes_pixel);
+}
+
+/* View on mirrored pixels (rows from bottom to top like textures, not to be freed) */
+Image CanvasMirror::get_image() const {
+  return Image(m_framebuffer.width, m_framebuffer.height, m_framebuffer.n_channels, const_cast<unsigned char*>(m_data.data()), false);
+}
+
+/* Framebuffer not freed (owned by calling code) */
+void CanvasMirror::free() {
+  m_readback.free();
+  m_pending.clear();
+}
@@ -1,7 +1,20 @@
+#include <algorithm>
+#include <iostream>
+
 #include "framebuffer/framebuffer.hpp"
 #include "framebuffer/framebuffer_exception.hpp"
 
-Framebuffer::Framebuffer() {
+Framebuffer::Framebuffer():
+  width(0),
+  height(0),
+  n_channels(0),
+  m_id_depth(0),
+  m_depth_attachment(GL_NONE),
+  m_n_samples(0),
+  m_id_resolve(0),
+  m_is_srgb(false),
+  m_was_srgb_enabled(false)
+{
   generate();
 }
 
@@ -9,15 +22,24 @@ void Framebuffer::generate() {
   glGenFramebuffers(1, &m_id);
 }
 
-/* Attach 2D texture as a color buffer to bound framebuffer */
-void Framebuffer::attach_texture(const Texture2D& texture) {
+/**
+ * Attach 2D texture as a color buffer (written by fragment shader output with `layout (location = i_attachment)`)
+ * Formats can differ between attachments (e.g. GL_RGBA16F normals & GL_RGBA albedo with `Texture2D`'s render-target ctor)
+ */
+void Framebuffer::attach_texture(const Texture2D& texture, unsigned int i_attachment) {
+  delete_renderbuffer(i_attachment);
   bind();
 
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture.type, texture.id, 0);
-  width = texture.width;
-  height = texture.height;
-  m_format = texture.format;
-  n_channels = texture.get_n_channels();
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i_attachment, texture.type, texture.id, 0);
+  if (i_attachment == 0) {
+    width = texture.width;
+    height = texture.height;
+    m_format = texture.format;
+    n_channels = texture.get_n_channels();
+  }
+  m_is_srgb = m_is_srgb || texture.is_srgb();
+
+  add_draw_buffer(i_attachment, is_integer_format(texture.format));
 
   if (!is_complete()) {
     throw FramebufferException();
@@ -26,30 +48,344 @@ void Framebuffer::attach_texture(const Texture2D& texture) {
   unbind();
 }
 
-/* Check if currently bound framebuffer is ready to use (has at least on buffer attached) */
-bool Framebuffer::is_complete() {
+/* All color attachments drawn to at once (called with framebuffer bound) */
+void Framebuffer::add_draw_buffer(unsigned int i_attachment, bool is_integer) {
+  if (m_draw_buffers.size() <= i_attachment) {
+    m_draw_buffers.resize(i_attachment + 1, GL_NONE);
+    m_is_integer.resize(i_attachment + 1, false);
+  }
+
+  m_draw_buffers[i_attachment] = GL_COLOR_ATTACHMENT0 + i_attachment;
+  m_is_integer[i_attachment] = is_integer;
+  glDrawBuffers(m_draw_buffers.size(), m_draw_buffers.data());
+  glReadBuffer(get_read_buffer());
+}
+
+/* Pixels read (e.g. by `get_pixel_value()`) from attachment 0 if any */
+GLenum Framebuffer::get_read_buffer() const {
+  if (m_draw_buffers.empty()) {
+    return GL_NONE;
+  }
+
+  return m_draw_buffers[0] != GL_NONE ? GL_COLOR_ATTACHMENT0 : m_draw_buffers.back();
+}
+
+/* Pixel format of integer textures (e.g. GL_RED_INTEGER) or sized internal format of integer renderbuffers */
+bool Framebuffer::is_integer_format(GLenum format) {
+  switch (format) {
+    case GL_RED_INTEGER:
+    case GL_RG_INTEGER:
+    case GL_RGB_INTEGER:
+    case GL_RGBA_INTEGER:
+    case GL_R8UI: case GL_R16UI: case GL_R32UI:
+    case GL_RG8UI: case GL_RG16UI: case GL_RG32UI:
+    case GL_RGBA8UI: case GL_RGBA16UI: case GL_RGBA32UI:
+    case GL_R8I: case GL_R16I: case GL_R32I:
+    case GL_RG8I: case GL_RG16I: case GL_RG32I:
+    case GL_RGBA8I: case GL_RGBA16I: case GL_RGBA32I:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Depth textures have format GL_DEPTH_COMPONENT, depth-stencil ones GL_DEPTH_STENCIL */
+GLenum Framebuffer::get_depth_attachment(GLenum format) {
+  switch (format) {
+    case GL_DEPTH_STENCIL:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH32F_STENCIL8:
+      return GL_DEPTH_STENCIL_ATTACHMENT;
+    default:
+      return GL_DEPTH_ATTACHMENT;
+  }
+}
+
+/**
+ * Attach depth (or depth-stencil) texture sampled afterwards (e.g. shadow map, SSAO)
+ * e.g. `Texture2D(w, h, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT)`
+ * Framebuffer without color attachment doesn't draw/read any color buffer
+ */
+void Framebuffer::attach_depth(const Texture2D& texture) {
   bind();
-  bool status = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+  m_depth_attachment = get_depth_attachment(texture.format);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, m_depth_attachment, texture.type, texture.id, 0);
+  if (m_draw_buffers.empty()) {
+    width = texture.width;
+    height = texture.height;
+    n_channels = texture.get_n_channels();
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+  }
+
+  if (!is_complete()) {
+    throw FramebufferException();
+  }
+
+  unbind();
+}
+
+/**
+ * Attach depth (or depth-stencil) buffer with size of color attachment (call after `attach_texture()`)
+ * Renderbuffer as depth isn't sampled afterwards (e.g. depth test of an offscreen 3D pass)
+ * Multisampled like color attachments made with `attach_multisample()`
+ * @param internal_format GL_DEPTH_COMPONENT24/32F, or GL_DEPTH24_STENCIL8 for stencil (e.g. outlines)
+ */
+void Framebuffer::attach_depth(GLenum internal_format) {
+  if (m_id_depth != 0) {
+    glDeleteRenderbuffers(1, &m_id_depth);
+  }
+
+  glGenRenderbuffers(1, &m_id_depth);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_id_depth);
+  glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_n_samples, internal_format, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  bind();
+  m_depth_attachment = get_depth_attachment(internal_format);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, m_depth_attachment, GL_RENDERBUFFER, m_id_depth);
+
+  if (!is_complete()) {
+    throw FramebufferException();
+  }
+
+  unbind();
+}
+
+/**
+ * Attach multisampled color buffer (MSAA: coverage sampled n times per pixel, shading once)
+ * Renderbuffer as multisampled pixels can't be sampled directly: `resolve()` them to a texture after the pass
+ * Cheaper than rendering at twice the resolution & downscaling (4x fill & bandwidth)
+ * @param n_samples Clamped to GL_MAX_SAMPLES (all attachments need the same #)
+ */
+void Framebuffer::attach_multisample(int w, int h, int n_samples, GLenum internal_format, unsigned int i_attachment) {
+  GLint n_samples_max;
+  glGetIntegerv(GL_MAX_SAMPLES, &n_samples_max);
+  m_n_samples = std::min(n_samples, n_samples_max);
+
+  // renderbuffer previously attached at same index replaced
+  delete_renderbuffer(i_attachment);
+  if (m_ids_color.size() <= i_attachment) {
+    m_ids_color.resize(i_attachment + 1, 0);
+  }
+
+  GLuint id_renderbuffer;
+  glGenRenderbuffers(1, &id_renderbuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, id_renderbuffer);
+  glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_n_samples, internal_format, w, h);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  m_ids_color[i_attachment] = id_renderbuffer;
+
+  bind();
+
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i_attachment, GL_RENDERBUFFER, id_renderbuffer);
+  if (i_attachment == 0) {
+    width = w;
+    height = h;
+    m_format = get_pixel_format(internal_format);
+    n_channels = (m_format == GL_RED || m_format == GL_RED_INTEGER) ? 1 :
+                 (m_format == GL_RG || m_format == GL_RG_INTEGER) ? 2 :
+                 (m_format == GL_RGB || m_format == GL_RGB_INTEGER) ? 3 : 4;
+  }
+  m_is_srgb = m_is_srgb || internal_format == GL_SRGB8_ALPHA8 || internal_format == GL_SRGB8;
+
+  add_draw_buffer(i_attachment, is_integer_format(internal_format));
+
+  if (!is_complete()) {
+    throw FramebufferException();
+  }
+
   unbind();
+}
+
+/* Free multisampled renderbuffer of attachment (when attaching another buffer at its index) */
+void Framebuffer::delete_renderbuffer(unsigned int i_attachment) {
+  if (i_attachment < m_ids_color.size() && m_ids_color[i_attachment] != 0) {
+    glDeleteRenderbuffers(1, &m_ids_color[i_attachment]);
+    m_ids_color[i_attachment] = 0;
+  }
+}
+
+/* Pixel format matching sized internal format of a renderbuffer (e.g. read back by `get_pixel_value()`) */
+GLenum Framebuffer::get_pixel_format(GLenum internal_format) {
+  switch (internal_format) {
+    case GL_R8: case GL_R16: case GL_R16F: case GL_R32F:
+      return GL_RED;
+    case GL_R8UI: case GL_R16UI: case GL_R32UI: case GL_R8I: case GL_R16I: case GL_R32I:
+      return GL_RED_INTEGER;
+    case GL_RG8: case GL_RG16: case GL_RG16F: case GL_RG32F:
+      return GL_RG;
+    case GL_RG8UI: case GL_RG16UI: case GL_RG32UI: case GL_RG8I: case GL_RG16I: case GL_RG32I:
+      return GL_RG_INTEGER;
+    case GL_RGB8: case GL_SRGB8: case GL_RGB16F: case GL_RGB32F: case GL_R11F_G11F_B10F:
+      return GL_RGB;
+    case GL_RGBA8UI: case GL_RGBA16UI: case GL_RGBA32UI: case GL_RGBA8I: case GL_RGBA16I: case GL_RGBA32I:
+      return GL_RGBA_INTEGER;
+    default:
+      return GL_RGBA;
+  }
+}
+
+/**
+ * Average samples of a color attachment into a single-sampled texture (e.g. sampled by post-processing)
+ * Blitted through a second framebuffer: texture needs the size of the multisampled attachment
+ * (a multisampled read framebuffer can't be scaled, downscale the resolved texture afterwards if needed)
+ * Single-sampled attachments can be blitted to a texture of any size
+ * (linear filtering when sizes differ, except for integer attachments which only support nearest)
+ */
+void Framebuffer::resolve(const Texture2D& texture, unsigned int i_attachment) {
+  bool is_same_size = texture.width == width && texture.height == height;
+  if (m_n_samples > 0 && !is_same_size) {
+    std::cout << "Resolve texture must have the size of the multisampled framebuffer" << '\n';
+    return;
+  }
+
+  if (m_id_resolve == 0) {
+    glGenFramebuffers(1, &m_id_resolve);
+  }
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id_resolve);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture.type, texture.id, 0);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, m_id);
+  glReadBuffer(GL_COLOR_ATTACHMENT0 + i_attachment);
+
+  bool is_integer = i_attachment < m_is_integer.size() && m_is_integer[i_attachment];
+  GLenum filter = (is_same_size || is_integer) ? GL_NEAREST : GL_LINEAR;
+  glBlitFramebuffer(0, 0, width, height, 0, 0, texture.width, texture.height, GL_COLOR_BUFFER_BIT, filter);
+
+  glReadBuffer(get_read_buffer());
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+}
+
+/**
+ * Check if framebuffer is ready to use (has at least one buffer attached)
+ * Previous binding restored directly (not with `unbind()`), as called between `bind()` & `unbind()` when attaching
+ */
+bool Framebuffer::is_complete() {
+  GLint id_previous;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &id_previous);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+  bool status = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+  glBindFramebuffer(GL_FRAMEBUFFER, id_previous);
 
   return status;
 }
 
 /**
- * Called each frame to clear fbo's color buffer before re-drawing
+ * Bind framebuffer for drawing only while clearing/invalidating it (previously bound one restored by `unbind_draw()`)
+ * sRGB encoding enabled like in `bind()`, so clear colors are encoded the same way as shader outputs
+ * @return Previously bound draw framebuffer & sRGB state
+ */
+Framebuffer::DrawBinding Framebuffer::bind_draw() const {
+  DrawBinding binding;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &binding.id_previous);
+  binding.was_srgb_enabled = glIsEnabled(GL_FRAMEBUFFER_SRGB);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id);
+
+  if (m_is_srgb) {
+    glEnable(GL_FRAMEBUFFER_SRGB);
+  }
+
+  return binding;
+}
+
+void Framebuffer::unbind_draw(const DrawBinding& binding) const {
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, binding.id_previous);
+
+  if (m_is_srgb && !binding.was_srgb_enabled) {
+    glDisable(GL_FRAMEBUFFER_SRGB);
+  }
+}
+
+/**
+ * Called each frame to clear fbo's color buffers (& depth/stencil if attached) before re-drawing
+ * Clears this framebuffer whichever one is bound (no global clear color changed)
+ * Integer attachments skipped (float clear undefined for them): clear them with `clear_color_uint()`
  * @param color Color components in [0, 1] (alpha = 1 => opaque)
  */
 void Framebuffer::clear(const glm::vec4& color) {
-  glClearColor(color.r, color.g, color.b, color.a);
-  glClear(GL_COLOR_BUFFER_BIT);
+  for (unsigned int i_attachment = 0; i_attachment < m_draw_buffers.size(); i_attachment++) {
+    if (m_draw_buffers[i_attachment] != GL_NONE && !m_is_integer[i_attachment]) {
+      clear_color(i_attachment, color);
+    }
+  }
+
+  if (m_depth_attachment != GL_NONE) {
+    clear_depth();
+  }
+}
+
+/* Clear one color attachment (e.g. to a different value per G-buffer target) */
+void Framebuffer::clear_color(unsigned int i_attachment, const glm::vec4& color) {
+  DrawBinding binding = bind_draw();
+  const GLfloat value[4] = { color.r, color.g, color.b, color.a };
+  glClearBufferfv(GL_COLOR, i_attachment, value);
+  unbind_draw(binding);
+}
+
+/* Unsigned integer attachments (e.g. GL_R32UI ids) can't be cleared with floats */
+void Framebuffer::clear_color_uint(unsigned int i_attachment, const glm::uvec4& value) {
+  DrawBinding binding = bind_draw();
+  const GLuint values[4] = { value.x, value.y, value.z, value.w };
+  glClearBufferuiv(GL_COLOR, i_attachment, values);
+  unbind_draw(binding);
+}
+
+/* @param stencil Ignored without a depth-stencil attachment */
+void Framebuffer::clear_depth(float depth, int stencil) {
+  DrawBinding binding = bind_draw();
+
+  if (m_depth_attachment == GL_DEPTH_STENCIL_ATTACHMENT) {
+    glClearBufferfi(GL_DEPTH_STENCIL, 0, depth, stencil);
+  } else {
+    glClearBufferfv(GL_DEPTH, 0, &depth);
+  }
+
+  unbind_draw(binding);
+}
+
+/**
+ * Tell driver contents of attachments aren't needed anymore (e.g. depth after the pass, transient targets)
+ * so it can skip storing them (tiled gpus) or loading them back before the next pass
+ * Only a hint: no-op when GL_ARB_invalidate_subdata (core in 4.3) is missing
+ * @param attachments e.g. GL_COLOR_ATTACHMENT1, GL_DEPTH_ATTACHMENT
+ */
+void Framebuffer::invalidate(const std::vector<GLenum>& attachments) {
+  if (!GLAD_GL_ARB_invalidate_subdata || attachments.empty()) {
+    return;
+  }
+
+  DrawBinding binding = bind_draw();
+  glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, attachments.size(), attachments.data());
+  unbind_draw(binding);
+}
+
+/* Depth (& stencil) only used for depth testing during the pass */
+void Framebuffer::invalidate_depth() {
+  if (m_depth_attachment != GL_NONE) {
+    invalidate({ m_depth_attachment });
+  }
 }
 
+/* sRGB encoding enabled while rendering to an sRGB attachment, previous state restored on `unbind()` */
 void Framebuffer::bind() const {
   glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+  m_was_srgb_enabled = glIsEnabled(GL_FRAMEBUFFER_SRGB);
+
+  if (m_is_srgb) {
+    glEnable(GL_FRAMEBUFFER_SRGB);
+  }
 }
 
 void Framebuffer::unbind() const {
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (m_is_srgb && !m_was_srgb_enabled) {
+    glDisable(GL_FRAMEBUFFER_SRGB);
+  }
 }
 
 /**
@@ -64,5 +400,17 @@ void Framebuffer::get_pixel_value(int x, int y, unsigned char* data) {
 }
 
 void Framebuffer::free() {
+  if (m_id_depth != 0) {
+    glDeleteRenderbuffers(1, &m_id_depth);
+  }
+
+  if (!m_ids_color.empty()) {
+    glDeleteRenderbuffers(m_ids_color.size(), m_ids_color.data());
+  }
+
+  if (m_id_resolve != 0) {
+    glDeleteFramebuffers(1, &m_id_resolve);
+  }
+
   glDeleteFramebuffers(1, &m_id);
 }
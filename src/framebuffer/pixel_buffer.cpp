@@ -0,0 +1,145 @@
+#include <iostream>
+
+#include "framebuffer/pixel_buffer.hpp"
+#include "texture/pixel_store.hpp"
+
+PixelBuffer::PixelBuffer():
+  m_fence(nullptr),
+  m_n_bytes(0),
+  m_n_bytes_read(0)
+{
+  glGenBuffers(1, &m_id);
+}
+
+/* @return 0 for unsupported formats */
+int PixelBuffer::get_n_components(GLenum format) {
+  switch (format) {
+    case GL_RED:
+    case GL_GREEN:
+    case GL_BLUE:
+    case GL_RED_INTEGER:
+    case GL_GREEN_INTEGER:
+    case GL_BLUE_INTEGER:
+    case GL_DEPTH_COMPONENT:
+    case GL_STENCIL_INDEX:
+      return 1;
+    case GL_RG:
+    case GL_RG_INTEGER:
+      return 2;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+    case GL_BGR_INTEGER:
+      return 3;
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER:
+    case GL_BGRA_INTEGER:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/* @return 0 for unsupported types (e.g. packed ones like GL_UNSIGNED_INT_24_8) */
+int PixelBuffer::get_n_bytes_component(GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+      return 2;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Queue copy of region of framebuffer's color attachment into the buffer (doesn't wait for the gpu)
+ * @param format Pixel format (e.g. GL_RGBA) with components of given type (1 byte each for GL_UNSIGNED_BYTE)
+ * @return false if format or type unsupported (nothing read)
+ */
+bool PixelBuffer::read(const Framebuffer& framebuffer, int x, int y, int width, int height, GLenum format, GLenum type) {
+  int n_components = get_n_components(format);
+  int n_bytes_component = get_n_bytes_component(type);
+  if (n_components == 0 || n_bytes_component == 0) {
+    std::cout << "Unsupported pixel format or type for readback: " << format << ", " << type << '\n';
+    return false;
+  }
+
+  size_t n_bytes = static_cast<size_t>(width) * height * n_components * n_bytes_component;
+  m_n_bytes_read = n_bytes;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_id);
+  if (n_bytes > m_n_bytes) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, n_bytes, NULL, GL_STREAM_READ);
+    m_n_bytes = n_bytes;
+  }
+
+  // rows tightly packed (default alignment of 4 bytes would pad rgb rows)
+  framebuffer.bind();
+  PixelStore pixel_store(true);
+  pixel_store.set_alignment(1);
+  glReadPixels(x, y, width, height, format, type, 0);
+  pixel_store.restore();
+  framebuffer.unbind();
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (m_fence != nullptr) {
+    glDeleteSync(m_fence);
+  }
+  m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  return true;
+}
+
+/* Readback queued & not mapped yet */
+bool PixelBuffer::is_pending() const {
+  return m_fence != nullptr;
+}
+
+/* Poll fence without blocking (flushes commands so the fence is eventually signaled) */
+bool PixelBuffer::is_ready() {
+  if (m_fence == nullptr) {
+    return false;
+  }
+
+  GLenum status = glClientWaitSync(m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+/**
+ * Access pixels read (to call only once `is_ready()`), valid until `unmap()`
+ * Rows ordered from bottom to top like with `glReadPixels()`
+ */
+const unsigned char* PixelBuffer::map() {
+  glDeleteSync(m_fence);
+  m_fence = nullptr;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_id);
+  return static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_n_bytes, GL_MAP_READ_BIT));
+}
+
+void PixelBuffer::unmap() {
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/* # of bytes of last region read (mapped range can be bigger) */
+size_t PixelBuffer::get_n_bytes() const {
+  return m_n_bytes_read;
+}
+
+void PixelBuffer::free() {
+  if (m_fence != nullptr) {
+    glDeleteSync(m_fence);
+  }
+
+  glDeleteBuffers(1, &m_id);
+}
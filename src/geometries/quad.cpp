@@ -0,0 +1,33 @@
+#include "geometries/quad.hpp"
+
+using namespace geometry;
+
+Quad::Quad() {
+  set_vertexes();
+  set_indices();
+  set_positions();
+}
+
+/* uv-coords derived from positions in vertex shader */
+void Quad::set_vertexes() {
+  m_vertexes = {
+    -1.0f, -1.0f,
+     1.0f, -1.0f,
+    -1.0f,  1.0f,
+     1.0f,  1.0f,
+  };
+}
+
+/* Triangle strip (see `Renderer::draw_plane()`) */
+void Quad::set_indices() {
+  m_indices = { 0, 1, 2, 3 };
+}
+
+void Quad::set_positions() {
+  m_positions = {
+    { -1.0f, -1.0f, 0.0f },
+    {  1.0f, -1.0f, 0.0f },
+    { -1.0f,  1.0f, 0.0f },
+    {  1.0f,  1.0f, 0.0f },
+  };
+}
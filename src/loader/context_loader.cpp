@@ -0,0 +1,151 @@
+#include "loader/context_loader.hpp"
+#include "texture/image_cache.hpp"
+
+/**
+ * @param make_current Makes shared context current on calling thread (e.g. `glfwMakeContextCurrent(window_hidden)`)
+ * @param release_current Detaches context before loader thread exits (optional)
+ */
+ContextLoader::ContextLoader(const std::function<void()>& make_current, const std::function<void()>& release_current):
+  m_is_stopped(false)
+{
+  m_thread = std::thread(&ContextLoader::run, this, make_current, release_current);
+}
+
+ContextLoader::~ContextLoader() {
+  stop();
+}
+
+/* Loop on loader thread: run creation jobs in submission order */
+void ContextLoader::run(const std::function<void()>& make_current, const std::function<void()>& release_current) {
+  make_current();
+
+  while (true) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_is_stopped || !m_jobs.empty(); });
+      if (m_is_stopped && m_jobs.empty()) {
+        break;
+      }
+
+      job = std::move(m_jobs.front());
+      m_jobs.pop();
+    }
+
+    job();
+  }
+
+  if (release_current) {
+    release_current();
+  }
+}
+
+/**
+ * Queue creation of object on loader thread
+ * Returned future becomes ready in a later `poll()` once gpu finished creating the object
+ * Exceptions thrown by `create` rethrown by future's `get()`
+ */
+template <typename T>
+std::shared_future<T> ContextLoader::submit(const std::function<T()>& create) {
+  auto promise = std::make_shared<std::promise<T>>();
+  std::shared_future<T> future = promise->get_future().share();
+
+  auto job = [this, create, promise]() {
+    try {
+      T object = create();
+
+      // flush so fence (& commands before it) reach the gpu
+      GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      glFlush();
+      add_pending(fence, [promise, object]() { promise->set_value(object); });
+    } catch (...) {
+      std::exception_ptr exception = std::current_exception();
+      add_pending(nullptr, [promise, exception]() { promise->set_exception(exception); });
+    }
+  };
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push(job);
+  }
+
+  m_condition.notify_one();
+  return future;
+}
+
+void ContextLoader::add_pending(GLsync fence, const std::function<void()>& fulfill) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pending.push_back({ fence, fulfill });
+}
+
+/**
+ * Called each frame on the main thread (without blocking)
+ * Hands over objects whose fence was signaled (their futures become ready)
+ */
+void ContextLoader::poll() {
+  std::vector<Pending> pending;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    pending.swap(m_pending);
+  }
+
+  std::vector<Pending> pending_left;
+  for (const Pending& item : pending) {
+    if (item.fence != nullptr) {
+      GLenum status = glClientWaitSync(item.fence, 0, 0);
+      if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        pending_left.push_back(item);
+        continue;
+      }
+
+      glDeleteSync(item.fence);
+    }
+
+    item.fulfill();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pending.insert(m_pending.begin(), pending_left.begin(), pending_left.end());
+}
+
+/* Finish queued jobs & join loader thread (objects still pending are handed over by later polls) */
+void ContextLoader::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_is_stopped) {
+      return;
+    }
+
+    m_is_stopped = true;
+  }
+
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+/* Decoding & upload both done on loader thread */
+std::shared_future<Texture2D> ContextLoader::load_texture(const std::string& path, GLenum index, Wrapping wrapping, bool flip) {
+  return submit<Texture2D>([=]() {
+    std::shared_ptr<const Image> image = ImageCache::get().load(path, flip);
+    return Texture2D(*image, index, wrapping);
+  });
+}
+
+/* Geometry shared with calling code as it's read later on loader thread */
+std::shared_future<VBO> ContextLoader::load_vbo(const std::shared_ptr<const Geometry>& geometry) {
+  return submit<VBO>([=]() {
+    return VBO(*geometry);
+  });
+}
+
+std::shared_future<Program> ContextLoader::load_program(const std::string& path_vertex, const std::string& path_fragment) {
+  return submit<Program>([=]() {
+    return Program(path_vertex, path_fragment);
+  });
+}
+
+// template instantiation (avoids linking error)
+template std::shared_future<Texture2D> ContextLoader::submit(const std::function<Texture2D()>&);
+template std::shared_future<VBO> ContextLoader::submit(const std::function<VBO()>&);
+template std::shared_future<Program> ContextLoader::submit(const std::function<Program()>&);
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BRUSH_SSE2
+#endif
+
+#include "paint/brush.hpp"
+
+Brush::Brush(float r, const glm::vec4& c, float h, float s, float o):
+  radius(r),
+  color(c),
+  hardness(h),
+  spacing(s),
+  opacity(o),
+  m_position(0.0f, 0.0f),
+  m_distance_next(0.0f)
+{
+}
+
+/**
+ * Straight-alpha src-over of brush color (alpha = coverage) onto pixel:
+ *   a = as + ad (1 - as), c = (cs as + cd ad (1 - as)) / a
+ * Images without alpha (gray or rgb) are opaque (ad = 1), so colors are only interpolated towards brush color
+ * Rounded by adding 0.5 & truncating (values >= 0), like the SSE2 path
+ */
+static void blend_pixel(unsigned char* pixel, int n_channels, const float (&color)[4], float coverage) {
+  if (coverage <= 0.0f) {
+    return;
+  }
+
+  bool has_alpha = n_channels == 2 || n_channels == 4;
+  int n_colors = has_alpha ? n_channels - 1 : std::min(n_channels, 3);
+  float weight_dst = (has_alpha ? pixel[n_colors] / 255.0f : 1.0f) * (1.0f - coverage);
+  float alpha = coverage + weight_dst;
+
+  for (int i_channel = 0; i_channel < n_colors; i_channel++) {
+    float value = (color[i_channel] * coverage + pixel[i_channel] * weight_dst) / alpha;
+    pixel[i_channel] = static_cast<unsigned char>(value + 0.5f);
+  }
+
+  if (has_alpha) {
+    pixel[n_colors] = static_cast<unsigned char>(alpha * 255.0f + 0.5f);
+  }
+}
+
+#ifdef BRUSH_SSE2
+/* Same src-over as `blend_pixel()` on an rgba pixel (as = coverage broadcast, pixels without coverage unchanged) */
+static __m128 blend_pixel_rgba(__m128 pixel, __m128 color, __m128 coverage) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 n_levels = _mm_set1_ps(255.0f);
+  const __m128 mask_alpha = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+  __m128 alpha_dst = _mm_div_ps(_mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)), n_levels);
+  __m128 weight_dst = _mm_mul_ps(alpha_dst, _mm_sub_ps(one, coverage));
+  __m128 alpha = _mm_add_ps(coverage, weight_dst);
+  __m128 colors = _mm_div_ps(_mm_add_ps(_mm_mul_ps(color, coverage), _mm_mul_ps(pixel, weight_dst)), alpha);
+  __m128 blended = _mm_or_ps(_mm_andnot_ps(mask_alpha, colors), _mm_and_ps(mask_alpha, _mm_mul_ps(alpha, n_levels)));
+
+  __m128 is_covered = _mm_cmpgt_ps(coverage, _mm_setzero_ps());
+  return _mm_or_ps(_mm_and_ps(is_covered, blended), _mm_andnot_ps(is_covered, pixel));
+}
+#endif
+
+/**
+ * Composite one stamp centered at given position (pixel centers at half-integers)
+ * Coverage falls linearly from hardness * radius to radius (at least over 1px => anti-aliased edge)
+ * Coverage of 4 pixels computed at once with SSE2, rgba pixels composited as 4 floats at once
+ * @return Modified rectangle (clipped to image)
+ */
+Rect Brush::stamp(Image& image, const glm::vec2& center) const {
+  Rect rect = Rect(
+    static_cast<int>(std::floor(center.x - radius)),
+    static_cast<int>(std::floor(center.y - radius)),
+    0, 0
+  );
+  rect.width = static_cast<int>(std::ceil(center.x + radius)) - rect.x;
+  rect.height = static_cast<int>(std::ceil(center.y + radius)) - rect.y;
+  rect = rect.clip(image.width, image.height);
+  if (rect.is_empty()) {
+    return rect;
+  }
+
+  float falloff = std::max(radius * (1.0f - hardness), 1.0f);
+  float inv_falloff = 1.0f / falloff;
+  float alpha = opacity * color.a;
+  int n_channels = image.n_channels;
+
+  // gray (& gray-alpha) images painted with luminance (alpha lane only used by SSE2 path, where it's overwritten)
+  float color_channels[4] = { 255.0f * color.r, 255.0f * color.g, 255.0f * color.b, 255.0f };
+  if (n_channels <= 2) {
+    color_channels[0] = 255.0f * (0.299f * color.r + 0.587f * color.g + 0.114f * color.b);
+  }
+
+#ifdef BRUSH_SSE2
+  const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+  const __m128 radius4 = _mm_set1_ps(radius);
+  const __m128 inv_falloff4 = _mm_set1_ps(inv_falloff);
+  const __m128 alpha4 = _mm_set1_ps(alpha);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 color4 = _mm_loadu_ps(color_channels);
+  const __m128i zero_i = _mm_setzero_si128();
+  alignas(16) float coverages[4];
+#endif
+
+  for (int y = rect.y; y < rect.y + rect.height; y++) {
+    float dy = y + 0.5f - center.y;
+    unsigned char* row = image.data + static_cast<size_t>(y) * image.width * n_channels;
+    int x = rect.x;
+
+#ifdef BRUSH_SSE2
+    const __m128 dy2 = _mm_set1_ps(dy * dy);
+
+    for (; x + 4 <= rect.x + rect.width; x += 4) {
+      __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets), _mm_set1_ps(center.x));
+      __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), dy2));
+      __m128 coverage = _mm_mul_ps(_mm_sub_ps(radius4, distance), inv_falloff4);
+      coverage = _mm_mul_ps(_mm_min_ps(_mm_max_ps(coverage, zero), one), alpha4);
+
+      // 4 pixels outside circle (e.g. corners of bounding box)
+      if (_mm_movemask_ps(_mm_cmpgt_ps(coverage, zero)) == 0) {
+        continue;
+      }
+
+      unsigned char* pixels = row + static_cast<size_t>(x) * n_channels;
+
+      if (n_channels != 4) {
+        _mm_store_ps(coverages, coverage);
+        for (int i_pixel = 0; i_pixel < 4; i_pixel++) {
+          blend_pixel(pixels + i_pixel * n_channels, n_channels, color_channels, coverages[i_pixel]);
+        }
+        continue;
+      }
+
+      // 16 bytes => 4 rgba pixels as 4 float vectors
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+      __m128i words_lo = _mm_unpacklo_epi8(bytes, zero_i);
+      __m128i words_hi = _mm_unpackhi_epi8(bytes, zero_i);
+      __m128 pixel0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words_lo, zero_i));
+      __m128 pixel1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words_lo, zero_i));
+      __m128 pixel2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words_hi, zero_i));
+      __m128 pixel3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words_hi, zero_i));
+
+      // src-over with coverage of each pixel broadcast to its 4 channels
+      pixel0 = blend_pixel_rgba(pixel0, color4, _mm_shuffle_ps(coverage, coverage, _MM_SHUFFLE(0, 0, 0, 0)));
+      pixel1 = blend_pixel_rgba(pixel1, color4, _mm_shuffle_ps(coverage, coverage, _MM_SHUFFLE(1, 1, 1, 1)));
+      pixel2 = blend_pixel_rgba(pixel2, color4, _mm_shuffle_ps(coverage, coverage, _MM_SHUFFLE(2, 2, 2, 2)));
+      pixel3 = blend_pixel_rgba(pixel3, color4, _mm_shuffle_ps(coverage, coverage, _MM_SHUFFLE(3, 3, 3, 3)));
+
+      // round like scalar path (+0.5 & truncation, not cvtps' half-to-even) & saturate back to bytes
+      __m128i words_lo_out = _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(pixel0, half)), _mm_cvttps_epi32(_mm_add_ps(pixel1, half)));
+      __m128i words_hi_out = _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(pixel2, half)), _mm_cvttps_epi32(_mm_add_ps(pixel3, half)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), _mm_packus_epi16(words_lo_out, words_hi_out));
+    }
+#endif
+
+    // remaining pixels of row (or whole row without SSE2)
+    for (; x < rect.x + rect.width; x++) {
+      float dx = x + 0.5f - center.x;
+      float distance = std::sqrt(dx*dx + dy*dy);
+      float coverage = std::clamp((radius - distance) * inv_falloff, 0.0f, 1.0f) * alpha;
+
+      if (coverage > 0.0f) {
+        blend_pixel(row + static_cast<size_t>(x) * n_channels, n_channels, color_channels, coverage);
+      }
+    }
+  }
+
+  return rect;
+}
+
+/* Stamp at mouse press */
+Rect Brush::begin_stroke(Image& image, const glm::vec2& position) {
+  m_position = position;
+  m_distance_next = std::max(spacing * 2.0f * radius, 1.0f);
+
+  return stamp(image, position);
+}
+
+/**
+ * Stamps evenly spaced on segment from previous position (on mouse drag)
+ * Distance left over carried to next segment, so spacing is independent of mouse events frequency
+ * @return Bounding rectangle of all stamps
+ */
+Rect Brush::continue_stroke(Image& image, const glm::vec2& position) {
+  float step = std::max(spacing * 2.0f * radius, 1.0f);
+  glm::vec2 segment = position - m_position;
+  float length = std::sqrt(segment.x*segment.x + segment.y*segment.y);
+  Rect rect;
+
+  float distance = m_distance_next;
+  for (; distance <= length; distance += step) {
+    rect = rect.merge(stamp(image, m_position + segment * (distance / length)));
+  }
+
+  m_distance_next = distance - length;
+  m_position = position;
+
+  return rect;
+}
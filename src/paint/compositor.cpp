@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COMPOSITOR_SSE2
+#endif
+
+#include "paint/compositor.hpp"
+
+/* Output image & cache allocated for given canvas size (layers need to be rgba images of same size) */
+Compositor::Compositor(int width, int height, int tile_size):
+  m_width(width),
+  m_height(height),
+  m_tile_size(tile_size),
+  m_n_tiles_x((width + tile_size - 1) / tile_size),
+  m_n_tiles_y((height + tile_size - 1) / tile_size),
+  m_i_active(0),
+  m_below(static_cast<size_t>(width) * height * 4, 0.0f),
+  m_output(static_cast<size_t>(width) * height * 4, 0),
+  m_is_dirty_below(m_n_tiles_x * m_n_tiles_y, true),
+  m_is_dirty_output(m_n_tiles_x * m_n_tiles_y, true),
+  m_tile(static_cast<size_t>(tile_size) * tile_size * 4)
+{
+}
+
+/* New layer on top of stack (becomes active) */
+void Compositor::add_layer(const Layer& layer) {
+  m_layers.push_back(layer);
+  set_active(m_layers.size() - 1);
+  mark_dirty(m_layers.size() - 1);
+}
+
+/* Call `mark_dirty()` after modifying layer (pixels, opacity, visibility, or blend mode) */
+Layer& Compositor::get_layer(unsigned int i_layer) {
+  return m_layers[i_layer];
+}
+
+unsigned int Compositor::get_n_layers() const {
+  return m_layers.size();
+}
+
+/* Layer being edited (cache below it rebuilt on next `compose()`) */
+void Compositor::set_active(unsigned int i_layer) {
+  if (i_layer == m_i_active) {
+    return;
+  }
+
+  m_i_active = i_layer;
+  std::fill(m_is_dirty_below.begin(), m_is_dirty_below.end(), true);
+  std::fill(m_is_dirty_output.begin(), m_is_dirty_output.end(), true);
+}
+
+/* Rectangle of layer modified (e.g. returned by `Brush::stamp()`) */
+void Compositor::mark_dirty(unsigned int i_layer, const Rect& rect) {
+  Rect dirty = rect.clip(m_width, m_height);
+  if (dirty.is_empty()) {
+    return;
+  }
+
+  for (int i_tile_y = dirty.y / m_tile_size; i_tile_y <= (dirty.y + dirty.height - 1) / m_tile_size; i_tile_y++) {
+    for (int i_tile_x = dirty.x / m_tile_size; i_tile_x <= (dirty.x + dirty.width - 1) / m_tile_size; i_tile_x++) {
+      unsigned int i_tile = i_tile_y * m_n_tiles_x + i_tile_x;
+      m_is_dirty_output[i_tile] = true;
+
+      if (i_layer < m_i_active) {
+        m_is_dirty_below[i_tile] = true;
+      }
+    }
+  }
+}
+
+/* Whole layer modified (e.g. opacity changed) */
+void Compositor::mark_dirty(unsigned int i_layer) {
+  mark_dirty(i_layer, Rect(0, 0, m_width, m_height));
+}
+
+Rect Compositor::get_tile_rect(unsigned int i_tile) const {
+  Rect rect((i_tile % m_n_tiles_x) * m_tile_size, (i_tile / m_n_tiles_x) * m_tile_size, m_tile_size, m_tile_size);
+  return rect.clip(m_width, m_height);
+}
+
+/**
+ * Separable blend modes in premultiplied alpha (s = source, b = backdrop, upper-case = premultiplied color):
+ * result = S (1 - ab) + B (1 - as) + as ab blend(s, b), with the last term also expressed with premultiplied colors
+ * Alpha lane gives as + ab - as ab for all modes
+ * The 4 channels of a pixel blended at once with SSE2
+ */
+#ifdef COMPOSITOR_SSE2
+static __m128 blend_pixel(__m128 backdrop, __m128 source, BlendMode blend_mode) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128 as = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+  __m128 ab = _mm_shuffle_ps(backdrop, backdrop, _MM_SHUFFLE(3, 3, 3, 3));
+  __m128 sb = _mm_mul_ps(source, backdrop);
+  __m128 mixed;
+
+  switch (blend_mode) {
+    case BlendMode::MULTIPLY:
+      mixed = sb;
+      break;
+    case BlendMode::SCREEN:
+      mixed = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(source, ab), _mm_mul_ps(backdrop, as)), sb);
+      break;
+    case BlendMode::OVERLAY: {
+      __m128 is_dark = _mm_cmple_ps(_mm_add_ps(backdrop, backdrop), ab);
+      __m128 dark = _mm_add_ps(sb, sb);
+      __m128 product = _mm_mul_ps(_mm_sub_ps(ab, backdrop), _mm_sub_ps(as, source));
+      __m128 light = _mm_sub_ps(_mm_mul_ps(as, ab), _mm_add_ps(product, product));
+      mixed = _mm_or_ps(_mm_and_ps(is_dark, dark), _mm_andnot_ps(is_dark, light));
+      break;
+    }
+    case BlendMode::ADD:
+      mixed = _mm_min_ps(_mm_add_ps(_mm_mul_ps(source, ab), _mm_mul_ps(backdrop, as)), _mm_mul_ps(as, ab));
+      break;
+    default:
+      mixed = _mm_mul_ps(source, ab);
+      break;
+  }
+
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(source, _mm_sub_ps(one, ab)), _mm_mul_ps(backdrop, _mm_sub_ps(one, as))), mixed);
+}
+#else
+static void blend_pixel(float* backdrop, const float* source, BlendMode blend_mode) {
+  float as = source[3];
+  float ab = backdrop[3];
+
+  for (int i_channel = 0; i_channel < 4; i_channel++) {
+    float s = source[i_channel];
+    float b = backdrop[i_channel];
+    float mixed;
+
+    switch (blend_mode) {
+      case BlendMode::MULTIPLY:
+        mixed = s * b;
+        break;
+      case BlendMode::SCREEN:
+        mixed = s * ab + b * as - s * b;
+        break;
+      case BlendMode::OVERLAY:
+        mixed = (2.0f * b <= ab) ? 2.0f * s * b : as * ab - 2.0f * (ab - b) * (as - s);
+        break;
+      case BlendMode::ADD:
+        mixed = std::min(s * ab + b * as, as * ab);
+        break;
+      default:
+        mixed = s * ab;
+        break;
+    }
+
+    backdrop[i_channel] = s * (1.0f - ab) + b * (1.0f - as) + mixed;
+  }
+}
+#endif
+
+/* Blend layer (straight-alpha bytes, premultiplied on the fly with its opacity) over tile buffer */
+void Compositor::blend_layer(const Layer& layer, const Rect& rect) {
+  float* pixels_tile = m_tile.data();
+  float scale = layer.opacity / 255.0f;
+
+  for (int y = rect.y; y < rect.y + rect.height; y++) {
+    const unsigned char* row = layer.image.data + (static_cast<size_t>(y) * m_width + rect.x) * 4;
+
+    for (int x = 0; x < rect.width; x++) {
+      const unsigned char* pixel = row + 4 * x;
+      float* backdrop = pixels_tile + 4 * ((y - rect.y) * rect.width + x);
+
+      // transparent pixels leave backdrop unchanged in all modes
+      if (pixel[3] == 0) {
+        continue;
+      }
+
+#ifdef COMPOSITOR_SSE2
+      int packed;
+      std::memcpy(&packed, pixel, 4);
+      __m128i bytes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128());
+      __m128 source = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(bytes, _mm_setzero_si128())), _mm_set1_ps(scale));
+      float alpha = pixel[3] / 255.0f;
+      source = _mm_mul_ps(source, _mm_setr_ps(alpha, alpha, alpha, 1.0f));
+      _mm_storeu_ps(backdrop, blend_pixel(_mm_loadu_ps(backdrop), source, layer.blend_mode));
+#else
+      float alpha = pixel[3] / 255.0f;
+      float source[4] = {
+        pixel[0] * scale * alpha,
+        pixel[1] * scale * alpha,
+        pixel[2] * scale * alpha,
+        pixel[3] * scale,
+      };
+      blend_pixel(backdrop, source, layer.blend_mode);
+#endif
+    }
+  }
+}
+
+/**
+ * Recompose dirty tiles: cache of layers below active one rebuilt if needed, then blended with the others
+ * @return Rectangles of recomposed tiles (to upload with `Texture2D::set_subimages()`)
+ */
+std::vector<Rect> Compositor::compose() {
+  std::vector<Rect> rects;
+
+  for (unsigned int i_tile = 0; i_tile < m_is_dirty_output.size(); i_tile++) {
+    if (!m_is_dirty_output[i_tile]) {
+      continue;
+    }
+
+    Rect rect = get_tile_rect(i_tile);
+    size_t n_values_row = static_cast<size_t>(rect.width) * 4;
+
+    if (m_is_dirty_below[i_tile]) {
+      std::fill(m_tile.begin(), m_tile.begin() + n_values_row * rect.height, 0.0f);
+      for (unsigned int i_layer = 0; i_layer < m_i_active; i_layer++) {
+        if (m_layers[i_layer].is_visible) {
+          blend_layer(m_layers[i_layer], rect);
+        }
+      }
+
+      for (int y = 0; y < rect.height; y++) {
+        float* row = &m_below[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4];
+        std::memcpy(row, &m_tile[y * n_values_row], n_values_row * sizeof(float));
+      }
+
+      m_is_dirty_below[i_tile] = false;
+    } else {
+      for (int y = 0; y < rect.height; y++) {
+        const float* row = &m_below[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4];
+        std::memcpy(&m_tile[y * n_values_row], row, n_values_row * sizeof(float));
+      }
+    }
+
+    for (unsigned int i_layer = m_i_active; i_layer < m_layers.size(); i_layer++) {
+      if (m_layers[i_layer].is_visible) {
+        blend_layer(m_layers[i_layer], rect);
+      }
+    }
+
+    // back to straight alpha for display & save
+    for (int y = 0; y < rect.height; y++) {
+      unsigned char* row = &m_output[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4];
+
+      for (int x = 0; x < rect.width; x++) {
+        const float* pixel = &m_tile[y * n_values_row + 4 * x];
+        float alpha = std::clamp(pixel[3], 0.0f, 1.0f);
+        float inv_alpha = (alpha > 0.0f) ? 1.0f / alpha : 0.0f;
+
+        for (int i_channel = 0; i_channel < 3; i_channel++) {
+          row[4*x + i_channel] = static_cast<unsigned char>(std::clamp(pixel[i_channel] * inv_alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        row[4*x + 3] = static_cast<unsigned char>(alpha * 255.0f + 0.5f);
+      }
+    }
+
+    m_is_dirty_output[i_tile] = false;
+    rects.push_back(rect);
+  }
+
+  return rects;
+}
+
+/* View on composited image (not to be freed, e.g. passed to `Texture2D::set_subimages()` or saved) */
+Image Compositor::get_image() const {
+  return Image(m_width, m_height, 4, const_cast<unsigned char*>(m_output.data()), false);
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FLOOD_FILL_SSE2
+#endif
+
+#include "paint/flood_fill.hpp"
+
+/* Tolerance clamped so that scalar & SSE2 paths agree (negative would otherwise reject the seed itself) */
+FloodFill::FloodFill(int t):
+  tolerance(std::clamp(t, 0, 255)),
+  m_width(0),
+  m_image(nullptr)
+{
+}
+
+/* Pixel within tolerance of seed color & not already in region */
+bool FloodFill::is_match(int x, int y) const {
+  size_t i_pixel = static_cast<size_t>(y) * m_image->width + x;
+  if (m_mask[i_pixel] != 0) {
+    return false;
+  }
+
+  const unsigned char* pixel = m_image->data + i_pixel * m_image->n_channels;
+  for (int i_channel = 0; i_channel < m_image->n_channels; i_channel++) {
+    if (std::abs(pixel[i_channel] - m_color_seed[i_channel]) > tolerance) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Matches of pixels [x, x + 4[ as bits 0-3
+ * Rgba pixels tested at once with SSE2: saturated |pixel - seed| - tolerance is zero for all channels of a match
+ */
+unsigned int FloodFill::get_matches(int x, int y) const {
+#ifdef FLOOD_FILL_SSE2
+  if (m_image->n_channels == 4) {
+    size_t i_pixel = static_cast<size_t>(y) * m_image->width + x;
+    uint32_t seed;
+    std::memcpy(&seed, m_color_seed, 4);
+
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_image->data + 4 * i_pixel));
+    __m128i color = _mm_set1_epi32(seed);
+    __m128i diff = _mm_or_si128(_mm_subs_epu8(pixels, color), _mm_subs_epu8(color, pixels));
+    __m128i excess = _mm_subs_epu8(diff, _mm_set1_epi8(static_cast<char>(tolerance)));
+    int matches = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(excess, _mm_setzero_si128())));
+
+    // pixels already in region
+    uint32_t masked;
+    std::memcpy(&masked, &m_mask[i_pixel], 4);
+    for (int i_lane = 0; i_lane < 4; i_lane++) {
+      if ((masked >> (8 * i_lane)) & 0xff) {
+        matches &= ~(1 << i_lane);
+      }
+    }
+
+    return matches;
+  }
+#endif
+
+  unsigned int matches = 0;
+  for (int i_lane = 0; i_lane < 4; i_lane++) {
+    matches |= is_match(x + i_lane, y) << i_lane;
+  }
+
+  return matches;
+}
+
+/* @return Leftmost x of matching run ending at x (x assumed matching) */
+int FloodFill::extend_left(int x, int y) const {
+  while (x >= 4) {
+    unsigned int matches = get_matches(x - 4, y);
+    if (matches != 0xf) {
+      // stop after highest mismatching lane
+      int i_lane = 3;
+      while (matches & (1 << i_lane)) {
+        i_lane--;
+      }
+      return x - 4 + i_lane + 1;
+    }
+    x -= 4;
+  }
+
+  while (x > 0 && is_match(x - 1, y)) {
+    x--;
+  }
+
+  return x;
+}
+
+/* @return First x >= given x that doesn't match (or x_end) */
+int FloodFill::extend_right(int x, int y, int x_end) const {
+  while (x + 4 <= x_end) {
+    unsigned int matches = get_matches(x, y);
+    if (matches != 0xf) {
+      int i_lane = 0;
+      while (matches & (1 << i_lane)) {
+        i_lane++;
+      }
+      return x + i_lane;
+    }
+    x += 4;
+  }
+
+  while (x < x_end && is_match(x, y)) {
+    x++;
+  }
+
+  return x;
+}
+
+/* @return First x >= given x that matches (or x_end) */
+int FloodFill::skip_mismatches(int x, int y, int x_end) const {
+  while (x + 4 <= x_end) {
+    unsigned int matches = get_matches(x, y);
+    if (matches != 0) {
+      int i_lane = 0;
+      while (!(matches & (1 << i_lane))) {
+        i_lane++;
+      }
+      return x + i_lane;
+    }
+    x += 4;
+  }
+
+  while (x < x_end && !is_match(x, y)) {
+    x++;
+  }
+
+  return x;
+}
+
+/**
+ * Compute region (in mask) from seed without modifying image
+ * Each popped seed is extended to a full horizontal span, then one seed is pushed
+ * per matching run on rows above & below the span
+ * @return Bounding rectangle of region (empty if seed outside image)
+ */
+Rect FloodFill::select(const Image& image, const glm::ivec2& seed) {
+  size_t n_pixels = static_cast<size_t>(image.width) * image.height;
+
+  // reset only rows covered by previous region (mask reused across calls)
+  if (m_mask.size() != n_pixels || m_width != image.width) {
+    m_mask.assign(n_pixels, 0);
+    m_width = image.width;
+  } else {
+    for (int y = m_rect.y; y < m_rect.y + m_rect.height; y++) {
+      std::memset(&m_mask[static_cast<size_t>(y) * image.width + m_rect.x], 0, m_rect.width);
+    }
+  }
+
+  m_rect = Rect();
+  if (seed.x < 0 || seed.y < 0 || seed.x >= image.width || seed.y >= image.height) {
+    return m_rect;
+  }
+
+  m_image = &image;
+  std::memset(m_color_seed, 0, 4);
+  std::memcpy(m_color_seed, image.data + (static_cast<size_t>(seed.y) * image.width + seed.x) * image.n_channels, image.n_channels);
+
+  m_stack.clear();
+  m_stack.push_back({ seed.x, seed.y });
+
+  while (!m_stack.empty()) {
+    Seed current = m_stack.back();
+    m_stack.pop_back();
+
+    // already reached from another span
+    if (!is_match(current.x, current.y)) {
+      continue;
+    }
+
+    int x_left = extend_left(current.x, current.y);
+    int x_right = extend_right(current.x, current.y, image.width);
+    std::memset(&m_mask[static_cast<size_t>(current.y) * image.width + x_left], 255, x_right - x_left);
+    m_rect = m_rect.merge(Rect(x_left, current.y, x_right - x_left, 1));
+
+    for (int y : { current.y - 1, current.y + 1 }) {
+      if (y < 0 || y >= image.height) {
+        continue;
+      }
+
+      int x = skip_mismatches(x_left, y, x_right);
+      while (x < x_right) {
+        m_stack.push_back({ x, y });
+        x = extend_right(x, y, x_right);
+        x = skip_mismatches(x, y, x_right);
+      }
+    }
+  }
+
+  m_image = nullptr;
+  return m_rect;
+}
+
+/**
+ * Paint bucket: replace region's pixels with given color (rgba in [0, 1])
+ * @return Dirty rectangle to upload (e.g. with `Texture2D::set_subimage()`)
+ */
+Rect FloodFill::fill(Image& image, const glm::ivec2& seed, const glm::vec4& color) {
+  Rect rect = select(image, seed);
+
+  unsigned char color_fill[4] = {
+    static_cast<unsigned char>(255.0f * std::clamp(color.r, 0.0f, 1.0f) + 0.5f),
+    static_cast<unsigned char>(255.0f * std::clamp(color.g, 0.0f, 1.0f) + 0.5f),
+    static_cast<unsigned char>(255.0f * std::clamp(color.b, 0.0f, 1.0f) + 0.5f),
+    static_cast<unsigned char>(255.0f * std::clamp(color.a, 0.0f, 1.0f) + 0.5f),
+  };
+  if (image.n_channels <= 2) {
+    // grayscale (& gray-alpha) images store luminance then alpha
+    color_fill[0] = static_cast<unsigned char>(0.299f * color_fill[0] + 0.587f * color_fill[1] + 0.114f * color_fill[2] + 0.5f);
+    color_fill[1] = color_fill[3];
+  }
+
+  for (int y = rect.y; y < rect.y + rect.height; y++) {
+    size_t i_row = static_cast<size_t>(y) * image.width;
+
+    for (int x = rect.x; x < rect.x + rect.width; x++) {
+      if (m_mask[i_row + x] != 0) {
+        std::memcpy(image.data + (i_row + x) * image.n_channels, color_fill, image.n_channels);
+      }
+    }
+  }
+
+  return rect;
+}
+
+/* Region of last call, usable as a selection (e.g. uploaded as a single-channel texture) */
+const std::vector<unsigned char>& FloodFill::get_mask() const {
+  return m_mask;
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cstring>
+
+#include "paint/undo_history.hpp"
+
+/**
+ * Run-length encoding of pixels: [run length - 1 (1 byte)][pixel] for runs of up to 256 identical pixels
+ * Cheap to encode/decode & efficient on flat areas (blank canvas, fills)
+ */
+static std::vector<unsigned char> encode_rle(const std::vector<unsigned char>& pixels, int n_channels) {
+  std::vector<unsigned char> encoded;
+  size_t n_pixels = pixels.size() / n_channels;
+  size_t i_pixel = 0;
+
+  while (i_pixel < n_pixels) {
+    const unsigned char* pixel = &pixels[i_pixel * n_channels];
+    size_t n_run = 1;
+    while (n_run < 256 && i_pixel + n_run < n_pixels &&
+           std::memcmp(pixel, &pixels[(i_pixel + n_run) * n_channels], n_channels) == 0) {
+      n_run++;
+    }
+
+    encoded.push_back(static_cast<unsigned char>(n_run - 1));
+    encoded.insert(encoded.end(), pixel, pixel + n_channels);
+    i_pixel += n_run;
+  }
+
+  return encoded;
+}
+
+static void decode_rle(const std::vector<unsigned char>& encoded, int n_channels, unsigned char* pixels) {
+  for (size_t i_byte = 0; i_byte < encoded.size(); i_byte += 1 + n_channels) {
+    size_t n_run = encoded[i_byte] + 1;
+    for (size_t i_run = 0; i_run < n_run; i_run++) {
+      std::memcpy(pixels, &encoded[i_byte + 1], n_channels);
+      pixels += n_channels;
+    }
+  }
+}
+
+/**
+ * Current image content becomes the initial state (image only viewed, not freed)
+ * @param max_bytes Oldest actions dropped when memory of tiles kept for undo/redo exceeds it
+ * @param is_compressed Run-length encode tiles
+ */
+UndoHistory::UndoHistory(const Image& image, int tile_size, size_t max_bytes, bool is_compressed):
+  m_image(image.width, image.height, image.n_channels, image.data, false),
+  m_tile_size(tile_size),
+  m_n_tiles_x((image.width + tile_size - 1) / tile_size),
+  m_n_tiles_y((image.height + tile_size - 1) / tile_size),
+  m_max_bytes(max_bytes),
+  m_is_compressed(is_compressed),
+  m_n_applied(0),
+  m_n_bytes(0)
+{
+  m_tiles.resize(m_n_tiles_x * m_n_tiles_y);
+  for (unsigned int i_tile = 0; i_tile < m_tiles.size(); i_tile++) {
+    m_tiles[i_tile] = copy_tile(i_tile);
+  }
+}
+
+/* Tiles on right & bottom borders cut by image size */
+Rect UndoHistory::get_tile_rect(unsigned int i_tile) const {
+  Rect rect((i_tile % m_n_tiles_x) * m_tile_size, (i_tile / m_n_tiles_x) * m_tile_size, m_tile_size, m_tile_size);
+  return rect.clip(m_image.width, m_image.height);
+}
+
+std::shared_ptr<const UndoHistory::Tile> UndoHistory::copy_tile(unsigned int i_tile) const {
+  Rect rect = get_tile_rect(i_tile);
+  size_t n_bytes_row = static_cast<size_t>(rect.width) * m_image.n_channels;
+  std::vector<unsigned char> pixels(n_bytes_row * rect.height);
+
+  for (int y = 0; y < rect.height; y++) {
+    const unsigned char* row = m_image.data + (static_cast<size_t>(rect.y + y) * m_image.width + rect.x) * m_image.n_channels;
+    std::memcpy(&pixels[y * n_bytes_row], row, n_bytes_row);
+  }
+
+  auto tile = std::make_shared<Tile>();
+  tile->is_compressed = false;
+
+  if (m_is_compressed) {
+    std::vector<unsigned char> encoded = encode_rle(pixels, m_image.n_channels);
+    if (encoded.size() < pixels.size()) {
+      tile->data = std::move(encoded);
+      tile->is_compressed = true;
+    }
+  }
+
+  if (!tile->is_compressed) {
+    tile->data = std::move(pixels);
+  }
+
+  return tile;
+}
+
+void UndoHistory::paste_tile(unsigned int i_tile, const Tile& tile) {
+  Rect rect = get_tile_rect(i_tile);
+  size_t n_bytes_row = static_cast<size_t>(rect.width) * m_image.n_channels;
+  const unsigned char* pixels = tile.data.data();
+
+  std::vector<unsigned char> decoded;
+  if (tile.is_compressed) {
+    decoded.resize(n_bytes_row * rect.height);
+    decode_rle(tile.data, m_image.n_channels, decoded.data());
+    pixels = decoded.data();
+  }
+
+  for (int y = 0; y < rect.height; y++) {
+    unsigned char* row = m_image.data + (static_cast<size_t>(rect.y + y) * m_image.width + rect.x) * m_image.n_channels;
+    std::memcpy(row, pixels + y * n_bytes_row, n_bytes_row);
+  }
+}
+
+/**
+ * Memory held by action's previous (or next) tiles
+ * A tile held for undo/redo is counted once: as previous tile of the action that replaced it,
+ * or as next tile of the last action that wrote it when this action is undone
+ */
+size_t UndoHistory::get_n_bytes(const Action& action, bool is_before) {
+  size_t n_bytes = 0;
+  for (const Change& change : action) {
+    n_bytes += (is_before ? change.before : change.after)->data.size();
+  }
+
+  return n_bytes;
+}
+
+/**
+ * Drop actions while memory exceeds the limit: oldest undoable ones first, then furthest redoable ones
+ * Previous tiles of the oldest action & next tiles of the last one aren't held anywhere else
+ */
+void UndoHistory::evict() {
+  while (m_n_bytes > m_max_bytes && m_actions.size() > 1) {
+    if (m_n_applied > 0) {
+      m_n_bytes -= get_n_bytes(m_actions.front(), true);
+      m_actions.pop_front();
+      m_n_applied--;
+    } else {
+      m_n_bytes -= get_n_bytes(m_actions.back(), false);
+      m_actions.pop_back();
+    }
+  }
+}
+
+/**
+ * Record action that modified given rectangle of the image (discards redoable actions)
+ * Only tiles overlapping the rectangle are copied
+ */
+void UndoHistory::commit(const Rect& rect) {
+  Rect dirty = rect.clip(m_image.width, m_image.height);
+  if (dirty.is_empty()) {
+    return;
+  }
+
+  // next tiles of redoable actions (their previous tiles are current or next tiles of an earlier one)
+  for (size_t i_action = m_n_applied; i_action < m_actions.size(); i_action++) {
+    m_n_bytes -= get_n_bytes(m_actions[i_action], false);
+  }
+  m_actions.resize(m_n_applied);
+
+  Action action;
+  for (int i_tile_y = dirty.y / m_tile_size; i_tile_y <= (dirty.y + dirty.height - 1) / m_tile_size; i_tile_y++) {
+    for (int i_tile_x = dirty.x / m_tile_size; i_tile_x <= (dirty.x + dirty.width - 1) / m_tile_size; i_tile_x++) {
+      unsigned int i_tile = i_tile_y * m_n_tiles_x + i_tile_x;
+      std::shared_ptr<const Tile> tile = copy_tile(i_tile);
+      action.push_back({ i_tile, m_tiles[i_tile], tile });
+      m_tiles[i_tile] = tile;
+    }
+  }
+
+  m_n_bytes += get_n_bytes(action, true);
+  m_actions.push_back(std::move(action));
+  m_n_applied++;
+  evict();
+}
+
+/* @return Rectangles of restored tiles (to upload with `Texture2D::set_subimages()`) */
+std::vector<Rect> UndoHistory::undo() {
+  std::vector<Rect> rects;
+  if (!can_undo()) {
+    return rects;
+  }
+
+  // next tiles no longer current but kept for redo
+  m_n_applied--;
+  for (const Change& change : m_actions[m_n_applied]) {
+    paste_tile(change.i_tile, *change.before);
+    m_tiles[change.i_tile] = change.before;
+    m_n_bytes += change.after->data.size() - change.before->data.size();
+    rects.push_back(get_tile_rect(change.i_tile));
+  }
+  evict();
+
+  return rects;
+}
+
+std::vector<Rect> UndoHistory::redo() {
+  std::vector<Rect> rects;
+  if (!can_redo()) {
+    return rects;
+  }
+
+  for (const Change& change : m_actions[m_n_applied]) {
+    paste_tile(change.i_tile, *change.after);
+    m_tiles[change.i_tile] = change.after;
+    m_n_bytes += change.before->data.size() - change.after->data.size();
+    rects.push_back(get_tile_rect(change.i_tile));
+  }
+  m_n_applied++;
+
+  return rects;
+}
+
+bool UndoHistory::can_undo() const {
+  return m_n_applied > 0;
+}
+
+bool UndoHistory::can_redo() const {
+  return m_n_applied < m_actions.size();
+}
+
+/* Memory held for undo/redo (excluding tiles of current state) */
+size_t UndoHistory::get_n_bytes() const {
+  return m_n_bytes;
+}
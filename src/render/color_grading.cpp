@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "render/color_grading.hpp"
+#include "geometries/quad.hpp"
+#include "vertexes/attributes.hpp"
+
+const std::string ColorGrading::SOURCE_VERTEX = R"(
+#version 330 core
+layout (location = 0) in vec2 position;
+out vec2 uv;
+
+void main() {
+  uv = (position + 1.0) / 2.0;
+  gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+// lut sampled at texel centers (color 0 & 1 map to first & last texels)
+const std::string ColorGrading::SOURCE_FRAGMENT = R"(
+#version 330 core
+in vec2 uv;
+out vec4 color_out;
+
+uniform sampler2D texture_color;
+uniform sampler3D lut;
+uniform float lut_size;
+
+void main() {
+  vec4 color = texture(texture_color, uv);
+  vec3 uvw = color.rgb * ((lut_size - 1.0) / lut_size) + 0.5 / lut_size;
+  color_out = vec4(texture(lut, uvw).rgb, color.a);
+}
+)";
+
+/**
+ * LUT initialized to identity
+ * @param lut_size # of samples along each color axis (interpolated linearly in-between)
+ * @param index_lut Texture unit of LUT (must differ from that of texture given to `apply()`)
+ */
+ColorGrading::ColorGrading(int lut_size, GLenum index_lut):
+  m_lut_size(lut_size),
+  m_lut(glm::uvec3(lut_size), 3, nullptr, index_lut, Wrapping::STRETCH),
+  m_renderer(Program::from_sources(SOURCE_VERTEX, SOURCE_FRAGMENT), geometry::Quad(), Attributes::get({ "position" }, 0, true))
+{
+  set_chain({});
+}
+
+/* Bake LUT by running every sample color through the chain (in order) */
+void ColorGrading::set_chain(const std::vector<ColorTransform>& chain) {
+  std::vector<unsigned char> voxels(m_lut_size * m_lut_size * m_lut_size * 3);
+  float step = 1.0f / (m_lut_size - 1);
+  size_t i_voxel = 0;
+
+  for (int b = 0; b < m_lut_size; b++) {
+    for (int g = 0; g < m_lut_size; g++) {
+      for (int r = 0; r < m_lut_size; r++) {
+        glm::vec3 color(r * step, g * step, b * step);
+        for (const ColorTransform& transform : chain) {
+          color = transform(color);
+        }
+
+        for (int i_channel = 0; i_channel < 3; i_channel++) {
+          voxels[i_voxel++] = static_cast<unsigned char>(std::clamp(color[i_channel], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+      }
+    }
+  }
+
+  m_lut.set_region(voxels.data(), m_lut.size, glm::uvec3(0));
+}
+
+/**
+ * Draw graded texture (e.g. color attachment of a `Framebuffer`) over the whole bound framebuffer
+ * Depth test disabled during the pass
+ */
+void ColorGrading::apply(const Texture2D& texture_color) {
+  GLboolean is_depth_test = glIsEnabled(GL_DEPTH_TEST);
+  glDisable(GL_DEPTH_TEST);
+
+  m_renderer.draw_plane({
+    { "texture_color", texture_color },
+    { "lut", m_lut },
+    { "lut_size", static_cast<float>(m_lut_size) },
+  });
+
+  if (is_depth_test) {
+    glEnable(GL_DEPTH_TEST);
+  }
+}
+
+void ColorGrading::free() {
+  m_lut.free();
+  m_renderer.free();
+  m_renderer.program.free();
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+#include "render/picking_pass.hpp"
+
+/* Same transforms as `Renderer::set_transform()` (one model matrix per instance) */
+std::string PickingPass::get_source_vertex(unsigned int n_instances_max) {
+  return R"(
+#version 330 core
+layout (location = 0) in vec3 position;
+flat out uint id;
+
+uniform mat4 models[)" + std::to_string(n_instances_max) + R"(];
+uniform mat4 view;
+uniform mat4 projection;
+uniform int object_id;
+
+void main() {
+  id = (uint(object_id) << 16) | uint(gl_InstanceID);
+  gl_Position = projection * view * models[gl_InstanceID] * vec4(position, 1.0);
+}
+)";
+}
+
+const std::string PickingPass::SOURCE_FRAGMENT = R"(
+#version 330 core
+flat in uint id;
+out uint id_out;
+
+void main() {
+  id_out = id;
+}
+)";
+
+/**
+ * @param width/height Size of pass (e.g. window size, as picks are made in screen coords)
+ * @param n_instances_max Size of `models` array in id shader
+ */
+PickingPass::PickingPass(int width, int height, unsigned int n_instances_max):
+  m_texture(width, height, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT),
+  m_framebuffer(),
+  m_program(Program::from_sources(get_source_vertex(n_instances_max), SOURCE_FRAGMENT)),
+  m_readback(2),
+  m_handle(nullptr),
+  m_x(0),
+  m_y(0),
+  m_n_instances_max(n_instances_max)
+{
+  m_framebuffer.attach_texture(m_texture);
+  m_framebuffer.attach_depth();
+}
+
+/* Clear ids to 0 (background) & depth, then draw renderers with `draw()` */
+void PickingPass::begin() {
+  glGetIntegerv(GL_VIEWPORT, m_viewport);
+  m_is_depth_test = glIsEnabled(GL_DEPTH_TEST);
+
+  m_framebuffer.bind();
+  glViewport(0, 0, m_framebuffer.width, m_framebuffer.height);
+  glEnable(GL_DEPTH_TEST);
+
+  // integer attachment can't be cleared with floats
+  m_framebuffer.clear_color_uint(0, glm::uvec4(0));
+  m_framebuffer.clear_depth();
+}
+
+/**
+ * Draw renderer's geometry (with its last transforms) using id shader
+ * Its own program swapped back afterwards, object id set on id shader directly (not kept in renderer's uniforms)
+ * Renderers with more instances than `models` array or than 16 bits can encode are skipped (not pickable)
+ */
+void PickingPass::draw(Renderer& renderer, unsigned int object_id) {
+  const unsigned int N_IDS_MAX = 1 << 16;
+  unsigned int n_instances = renderer.get_n_instances();
+  if (n_instances > std::min(m_n_instances_max, N_IDS_MAX) || object_id >= N_IDS_MAX) {
+    std::cout << "Picking: object " << object_id << " with " << n_instances << " instances can't be encoded in ids" << '\n';
+    return;
+  }
+
+  m_program.use();
+  m_program.set_uniforms({ { "object_id", static_cast<int>(object_id) } });
+  m_program.unuse();
+
+  Program program = renderer.program;
+  renderer.program = m_program;
+  renderer.draw({});
+  renderer.program = program;
+}
+
+/* Depth only needed during the pass */
+void PickingPass::end() {
+  m_framebuffer.invalidate_depth();
+  m_framebuffer.unbind();
+  glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+
+  if (!m_is_depth_test) {
+    glDisable(GL_DEPTH_TEST);
+  }
+}
+
+/**
+ * Queue readback of a small square around cursor (after `end()`)
+ * @param x/y Cursor in framebuffer coords (origin at lower-left)
+ * @param radius Closest hit within it is picked (tolerant to clicks next to thin objects)
+ */
+void PickingPass::request(int x, int y, int radius) {
+  m_x = x;
+  m_y = y;
+  m_handle = m_readback.read_rect(m_framebuffer, Rect(x - radius, y - radius, 2*radius + 1, 2*radius + 1), GL_RED_INTEGER, GL_UNSIGNED_INT);
+}
+
+/**
+ * Poll last request (called once per frame)
+ * @return false if no request finished since last call (pick left unchanged)
+ */
+bool PickingPass::get_pick(Pick& pick) {
+  m_readback.update();
+  if (m_handle == nullptr || !m_handle->is_ready) {
+    return false;
+  }
+
+  const ReadbackResult& result = *m_handle;
+  const GLuint* ids = reinterpret_cast<const GLuint*>(result.data.data());
+  int distance_min = std::numeric_limits<int>::max();
+  pick = { false, 0, 0 };
+
+  for (int y = 0; y < result.rect.height; y++) {
+    for (int x = 0; x < result.rect.width; x++) {
+      GLuint id = ids[y * result.rect.width + x];
+      int dx = result.rect.x + x - m_x;
+      int dy = result.rect.y + y - m_y;
+      int distance = dx*dx + dy*dy;
+
+      if (id != 0 && distance < distance_min) {
+        distance_min = distance;
+        pick = { true, id >> 16, id & 0xffff };
+      }
+    }
+  }
+
+  m_handle = nullptr;
+  return true;
+}
+
+void PickingPass::free() {
+  m_readback.free();
+  m_program.free();
+  m_texture.free();
+  m_framebuffer.free();
+}
@@ -18,7 +18,24 @@ Renderer::Renderer(const Program& pgm, const Geometry& geometry, const std::vect
   program(pgm),
   m_n_instances(1)
 {
-  // create vertex attributes linking bound VAO and VBO (& EBO with it)
+  set_attributes(attributes);
+}
+
+/**
+ * Renderer for a VBO created beforehand (e.g. on another thread by `ContextLoader`)
+ * VAO created here as VAOs aren't shared between GL contexts
+ */
+Renderer::Renderer(const Program& pgm, const VBO& v, const std::vector<Attribute>& attributes):
+  m_vao(),
+  vbo(v),
+  program(pgm),
+  m_n_instances(1)
+{
+  set_attributes(attributes);
+}
+
+/* Create vertex attributes linking bound VAO and VBO (& EBO with it) */
+void Renderer::set_attributes(const std::vector<Attribute>& attributes) {
   m_vao.bind();
   vbo.bind();
 
@@ -43,6 +60,11 @@ void Renderer::set_transform(const Transformation& transform) {
   m_uniforms["projection"] = transform.projection;
 }
 
+/* Set by last `set_transform()` (e.g. checked against size of `models` array in another shader) */
+GLsizei Renderer::get_n_instances() const {
+  return m_n_instances;
+}
+
 /* Different functions for every type of primitive (triangles, strips, lines) */
 void Renderer::draw(const Uniforms& u) {
   _draw(u, GL_TRIANGLES, vbo.n_elements);
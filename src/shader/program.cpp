@@ -20,7 +20,28 @@ Program::Program(const std::string& path_vertex, const std::string& path_fragmen
   // read shader source codes into strings (newer GLSL version not supported)
   std::string source_vertex = File::get_content(path_vertex);
   std::string source_fragment = File::get_content(path_fragment);
+  link(source_vertex, source_fragment);
+}
+
+/* Used by `from_sources()` */
+Program::Program():
+  id(0)
+{
+}
+
+/**
+ * Program from shaders embedded in the library (e.g. fullscreen passes), not read from files
+ * `has_failed()` true if compilation or linking failed
+ */
+Program Program::from_sources(const std::string& source_vertex, const std::string& source_fragment) {
+  Program program;
+  program.link(source_vertex, source_fragment);
+
+  return program;
+}
 
+/* Compile shaders & link them into program (id = 0 on failure) */
+void Program::link(const std::string& source_vertex, const std::string& source_fragment) {
   // create vertex & fragment shaders
   Shader shader_vertex(source_vertex, GL_VERTEX_SHADER);
   Shader shader_fragment(source_fragment, GL_FRAGMENT_SHADER);
@@ -142,6 +163,12 @@ void Program::set_uniforms(const Uniforms& uniforms) {
     } else if (auto ptr_value = std::get_if<Texture3D>(&value_uniform)) {
       ptr_value->attach();
       set_int(key_uniform, ptr_value->get_index());
+    } else if (auto ptr_value = std::get_if<Texture2DArray>(&value_uniform)) {
+      ptr_value->attach();
+      set_int(key_uniform, ptr_value->get_index());
+    } else if (auto ptr_value = std::get_if<TextureVolume>(&value_uniform)) {
+      ptr_value->attach();
+      set_int(key_uniform, ptr_value->get_index());
     } else {
       std::cout << "Incompatible value type" << '\n';
     }
@@ -0,0 +1,98 @@
+#include "texture/bricked_volume.hpp"
+#include "texture/texture_exception.hpp"
+
+/**
+ * @param n_bricks_side Pool holds `n_bricks_side^3` bricks (at most 256 per side as indirection stores 8-bits coords)
+ * @param n_uploads_max Max # of bricks uploaded in `update()`
+ */
+BrickedVolume::BrickedVolume(BrickSource& source, unsigned int n_bricks_side, unsigned int n_uploads_max,
+                             GLenum index_pool, GLenum index_indirection):
+  m_source(source),
+  m_page_manager(n_bricks_side * n_bricks_side * n_bricks_side),
+  m_n_bricks_side(n_bricks_side),
+  m_n_uploads_max(n_uploads_max)
+{
+  if (n_bricks_side == 0 || n_bricks_side > 256) {
+    throw TextureException("Bricked volume pool must have between 1 & 256 bricks per side");
+  }
+
+  // pool allocated without data (filled brick by brick)
+  unsigned int brick_size = source.get_brick_size();
+  glm::uvec3 size_pool(n_bricks_side * brick_size);
+  pool = TextureVolume(size_pool, source.get_n_channels(), nullptr, index_pool, Wrapping::STRETCH, brick_size);
+
+  // all bricks initially not resident
+  glm::uvec3 n_bricks = source.get_n_bricks();
+  std::vector<unsigned char> entries(n_bricks.x * n_bricks.y * n_bricks.z * 4, 0);
+  indirection = TextureVolume(n_bricks, 4, entries.data(), index_indirection, Wrapping::STRETCH, 1);
+  indirection.set_filters(GL_NEAREST, GL_NEAREST);
+}
+
+/* 21 bits per axis */
+uint64_t BrickedVolume::get_key(const glm::uvec3& brick) {
+  return (static_cast<uint64_t>(brick.z) << 42) | (static_cast<uint64_t>(brick.y) << 21) | brick.x;
+}
+
+glm::uvec3 BrickedVolume::get_brick(uint64_t key) {
+  uint64_t mask = (1 << 21) - 1;
+  return glm::uvec3(key & mask, (key >> 21) & mask, key >> 42);
+}
+
+/* Mark brick as needed for current frame (requests cleared after every `update()`) */
+void BrickedVolume::request(const glm::uvec3& brick) {
+  glm::uvec3 n_bricks = m_source.get_n_bricks();
+  if (brick.x >= n_bricks.x || brick.y >= n_bricks.y || brick.z >= n_bricks.z) {
+    return;
+  }
+
+  uint64_t key = get_key(brick);
+  if (m_keys_requested.insert(key).second) {
+    m_requests.push_back(brick);
+  }
+}
+
+/* Load & upload requested bricks that aren't resident yet (within upload budget, see `PageManager::load_missing()`) */
+void BrickedVolume::update() {
+  std::vector<uint64_t> keys;
+  for (const glm::uvec3& brick : m_requests) {
+    keys.push_back(get_key(brick));
+  }
+
+  m_page_manager.load_missing(keys, m_n_uploads_max, [&](uint64_t key, const PageSlot& page_slot) {
+    if (page_slot.has_evicted) {
+      set_indirection_entry(get_brick(page_slot.key_evicted), 0, false);
+    }
+
+    // copy brick to its slot in the pool
+    glm::uvec3 brick = get_brick(key);
+    glm::uvec3 slot(
+      page_slot.slot % m_n_bricks_side,
+      (page_slot.slot / m_n_bricks_side) % m_n_bricks_side,
+      page_slot.slot / (m_n_bricks_side * m_n_bricks_side)
+    );
+    std::vector<unsigned char> voxels = m_source.get_brick(brick);
+    pool.set_brick(voxels.data(), slot);
+
+    set_indirection_entry(brick, page_slot.slot, true);
+  });
+
+  m_requests.clear();
+  m_keys_requested.clear();
+}
+
+/* Point indirection's texel to brick's position in pool */
+void BrickedVolume::set_indirection_entry(const glm::uvec3& brick, unsigned int slot, bool is_resident) {
+  unsigned char entry[4] = {
+    static_cast<unsigned char>(slot % m_n_bricks_side),
+    static_cast<unsigned char>((slot / m_n_bricks_side) % m_n_bricks_side),
+    static_cast<unsigned char>(slot / (m_n_bricks_side * m_n_bricks_side)),
+    static_cast<unsigned char>(is_resident ? 255 : 0),
+  };
+
+  indirection.set_region(entry, glm::uvec3(1, 1, 1), brick);
+}
+
+void BrickedVolume::free() {
+  pool.free();
+  indirection.free();
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLOR_SPACE_SSE2
+#endif
+
+#include "texture/color_space.hpp"
+
+/* Resolution of linear -> sRGB table (finer than 256 as dark linear values are stretched by encoding) */
+static const int N_ENTRIES_ENCODE = 4096;
+
+/* Tables built once on first use */
+static const std::array<float, 256>& get_table_decode() {
+  static const std::array<float, 256> table = []() {
+    std::array<float, 256> values;
+    for (int i = 0; i < 256; i++) {
+      float value = i / 255.0f;
+      values[i] = (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+    return values;
+  }();
+
+  return table;
+}
+
+static const std::array<unsigned char, N_ENTRIES_ENCODE>& get_table_encode() {
+  static const std::array<unsigned char, N_ENTRIES_ENCODE> table = []() {
+    std::array<unsigned char, N_ENTRIES_ENCODE> values;
+    for (int i = 0; i < N_ENTRIES_ENCODE; i++) {
+      float value = (i + 0.5f) / N_ENTRIES_ENCODE;
+      float encoded = (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+      values[i] = static_cast<unsigned char>(encoded * 255.0f + 0.5f);
+    }
+    return values;
+  }();
+
+  return table;
+}
+
+float ColorSpace::srgb_to_linear(unsigned char value) {
+  return get_table_decode()[value];
+}
+
+unsigned char ColorSpace::linear_to_srgb(float value) {
+  int index = static_cast<int>(std::clamp(value, 0.0f, 1.0f) * (N_ENTRIES_ENCODE - 1));
+  return get_table_encode()[index];
+}
+
+/* @return Linear values in [0, 1] (same layout as image data) */
+std::vector<float> ColorSpace::to_linear(const Image& image) {
+  const std::array<float, 256>& table = get_table_decode();
+  size_t n_values = static_cast<size_t>(image.width) * image.height * image.n_channels;
+  std::vector<float> values(n_values);
+  bool has_alpha = (image.n_channels == 4);
+
+  for (size_t i_value = 0; i_value < n_values; i_value++) {
+    unsigned char value = image.data[i_value];
+    values[i_value] = (has_alpha && i_value % 4 == 3) ? value / 255.0f : table[value];
+  }
+
+  return values;
+}
+
+/**
+ * Encode linear values into image data (already allocated with same size)
+ * Clamping & scaling to table indices vectorized with SSE2 (4 values at once), then table lookups
+ */
+void ColorSpace::to_srgb(const std::vector<float>& values, Image& image) {
+  const std::array<unsigned char, N_ENTRIES_ENCODE>& table = get_table_encode();
+  size_t n_values = values.size();
+  size_t i_value = 0;
+
+#ifdef COLOR_SPACE_SSE2
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(N_ENTRIES_ENCODE - 1);
+  alignas(16) int indices[4];
+
+  for (; i_value + 4 <= n_values; i_value += 4) {
+    __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&values[i_value]), zero), one);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(_mm_mul_ps(value, scale)));
+
+    for (size_t i_lane = 0; i_lane < 4; i_lane++) {
+      image.data[i_value + i_lane] = table[indices[i_lane]];
+    }
+  }
+#endif
+
+  for (; i_value < n_values; i_value++) {
+    image.data[i_value] = linear_to_srgb(values[i_value]);
+  }
+
+  // alpha kept linear
+  if (image.n_channels == 4) {
+    for (size_t i_alpha = 3; i_alpha < n_values; i_alpha += 4) {
+      image.data[i_alpha] = static_cast<unsigned char>(std::clamp(values[i_alpha], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+  }
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CUBEMAP_SSE2
+#endif
+
+#include "texture/cubemap.hpp"
+
+static const float PI = 3.14159265358979f;
+
+/**
+ * Direction pointed to by texel of a cubemap face (not normalized)
+ * @param s/t Texel coords in [-1, 1], t pointing down (first row of face at t = -1)
+ * https://www.khronos.org/opengl/wiki/Cubemap_Texture
+ */
+glm::vec3 Cubemap::get_direction(int i_face, float s, float t) {
+  switch (i_face) {
+    case 0: return glm::vec3(1.0f, -t, -s);
+    case 1: return glm::vec3(-1.0f, -t, s);
+    case 2: return glm::vec3(s, 1.0f, t);
+    case 3: return glm::vec3(s, -1.0f, -t);
+    case 4: return glm::vec3(s, -t, 1.0f);
+  }
+
+  return glm::vec3(-s, -t, -1.0f);
+}
+
+/* Bilinear interpolation of one channel between the 4 texels around lookup point */
+static unsigned char lerp_channel(const unsigned char* p00, const unsigned char* p01, const unsigned char* p10, const unsigned char* p11,
+                                  int i_channel, float du, float dv) {
+  float bottom = p00[i_channel] + du * (p01[i_channel] - p00[i_channel]);
+  float top = p10[i_channel] + du * (p11[i_channel] - p10[i_channel]);
+  return static_cast<unsigned char>(bottom + dv * (top - bottom) + 0.5f);
+}
+
+#ifdef CUBEMAP_SSE2
+/* Rgba texel widened to 4 floats */
+static __m128 load_texel(const unsigned char* texel, __m128i zero) {
+  int packed;
+  std::memcpy(&packed, texel, 4);
+  __m128i bytes = _mm_cvtsi32_si128(packed);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+#endif
+
+/**
+ * Resample face of cubemap from equirectangular panorama with bilinear filtering
+ * Rows processed as arrays of coords: directions & texel coords computed for 4 texels at once with SSE2,
+ * and rgba texels interpolated as 4 floats at once (atan2 & asin stay scalar)
+ */
+static void resample_face(const Image& image, Image& face, int i_face) {
+  int size = face.width;
+  int n_channels = image.n_channels;
+  std::vector<float> xs(size), ys(size), zs(size), us(size), vs(size);
+
+  // direction is affine in (s, t): origin + s * axis_s + t * axis_t (same operations in both paths => same signed zeros at poles)
+  glm::vec3 origin = Cubemap::get_direction(i_face, 0.0f, 0.0f);
+  glm::vec3 axis_s = Cubemap::get_direction(i_face, 1.0f, 0.0f) - origin;
+  glm::vec3 axis_t = Cubemap::get_direction(i_face, 0.0f, 1.0f) - origin;
+#ifdef CUBEMAP_SSE2
+  int size_simd = size & ~3;
+#endif
+
+  for (int y = 0; y < size; y++) {
+    float t = 2.0f * (y + 0.5f) / size - 1.0f;
+    glm::vec3 row_origin = origin + t * axis_t;
+    int x = 0;
+
+    // directions of row's texels (normalized)
+#ifdef CUBEMAP_SSE2
+    const __m128 scale = _mm_set1_ps(2.0f / size);
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 row_x = _mm_set1_ps(row_origin.x);
+    __m128 row_y = _mm_set1_ps(row_origin.y);
+    __m128 row_z = _mm_set1_ps(row_origin.z);
+
+    for (; x < size_simd; x += 4) {
+      __m128 s = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets), scale), _mm_set1_ps(1.0f));
+      __m128 dx = _mm_add_ps(row_x, _mm_mul_ps(s, _mm_set1_ps(axis_s.x)));
+      __m128 dy = _mm_add_ps(row_y, _mm_mul_ps(s, _mm_set1_ps(axis_s.y)));
+      __m128 dz = _mm_add_ps(row_z, _mm_mul_ps(s, _mm_set1_ps(axis_s.z)));
+      __m128 norm = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+      _mm_storeu_ps(&xs[x], _mm_div_ps(dx, norm));
+      _mm_storeu_ps(&ys[x], _mm_div_ps(dy, norm));
+      _mm_storeu_ps(&zs[x], _mm_div_ps(dz, norm));
+    }
+#endif
+
+    for (; x < size; x++) {
+      float s = (x + 0.5f) * (2.0f / size) - 1.0f;
+      glm::vec3 direction = row_origin + s * axis_s;
+      float norm = std::sqrt(direction.x*direction.x + direction.y*direction.y + direction.z*direction.z);
+      xs[x] = direction.x / norm;
+      ys[x] = direction.y / norm;
+      zs[x] = direction.z / norm;
+    }
+
+    // longitude & latitude mapped to texel coords in panorama (panorama loaded flipped: bottom row first)
+    for (x = 0; x < size; x++) {
+      us[x] = std::atan2(xs[x], -zs[x]);
+      vs[x] = std::asin(ys[x]);
+    }
+
+    x = 0;
+#ifdef CUBEMAP_SSE2
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 scale_u = _mm_set1_ps(image.width / (2.0f * PI));
+    const __m128 scale_v = _mm_set1_ps(image.height / PI);
+    const __m128 offset_u = _mm_set1_ps(0.5f * image.width - 0.5f);
+    const __m128 offset_v = _mm_set1_ps(0.5f * image.height - 0.5f);
+
+    for (; x < size_simd; x += 4) {
+      _mm_storeu_ps(&us[x], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&us[x]), scale_u), offset_u));
+      _mm_storeu_ps(&vs[x], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&vs[x]), scale_v), offset_v));
+    }
+#endif
+
+    for (; x < size; x++) {
+      us[x] = us[x] * (image.width / (2.0f * PI)) + (0.5f * image.width - 0.5f);
+      vs[x] = vs[x] * (image.height / PI) + (0.5f * image.height - 0.5f);
+    }
+
+    unsigned char* row = face.data + static_cast<size_t>(y) * size * n_channels;
+    for (x = 0; x < size; x++) {
+      float u = us[x];
+      float v = std::fmin(std::fmax(vs[x], 0.0f), image.height - 1.0f);
+      int u0 = static_cast<int>(std::floor(u));
+      int v0 = static_cast<int>(v);
+      float du = u - u0;
+      float dv = v - v0;
+
+      // wrap horizontally (longitude), clamp vertically (poles)
+      int u_left = (u0 % image.width + image.width) % image.width;
+      int u_right = (u_left + 1) % image.width;
+      int v_top = std::min(v0 + 1, image.height - 1);
+
+      const unsigned char* p00 = image.data + (static_cast<size_t>(v0) * image.width + u_left) * n_channels;
+      const unsigned char* p01 = image.data + (static_cast<size_t>(v0) * image.width + u_right) * n_channels;
+      const unsigned char* p10 = image.data + (static_cast<size_t>(v_top) * image.width + u_left) * n_channels;
+      const unsigned char* p11 = image.data + (static_cast<size_t>(v_top) * image.width + u_right) * n_channels;
+
+#ifdef CUBEMAP_SSE2
+      // same arithmetic as scalar path (+0.5 then truncation) so both paths give identical bytes
+      if (n_channels == 4) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128 t00 = load_texel(p00, zero), t01 = load_texel(p01, zero);
+        __m128 t10 = load_texel(p10, zero), t11 = load_texel(p11, zero);
+        __m128 bottom = _mm_add_ps(t00, _mm_mul_ps(_mm_set1_ps(du), _mm_sub_ps(t01, t00)));
+        __m128 top = _mm_add_ps(t10, _mm_mul_ps(_mm_set1_ps(du), _mm_sub_ps(t11, t10)));
+        __m128 texel = _mm_add_ps(_mm_add_ps(bottom, _mm_mul_ps(_mm_set1_ps(dv), _mm_sub_ps(top, bottom))), half);
+        __m128i words = _mm_packs_epi32(_mm_cvttps_epi32(texel), zero);
+        int packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, zero));
+        std::memcpy(row + x * 4, &packed, 4);
+        continue;
+      }
+#endif
+
+      for (int i_channel = 0; i_channel < n_channels; i_channel++) {
+        row[x * n_channels + i_channel] = lerp_channel(p00, p01, p10, p11, i_channel, du, dv);
+      }
+    }
+  }
+}
+
+/**
+ * Split equirectangular panorama (longitude along x, latitude along y) into 6 cubemap faces
+ * Faces resampled in parallel (one thread per face)
+ * @param size Width & height of each face
+ * @return Faces allocated with malloc (freed with `Image::free()` like images loaded by stb)
+ */
+std::vector<Image> Cubemap::from_equirectangular(const Image& image, int size) {
+  std::vector<Image> faces;
+  for (int i_face = 0; i_face < 6; i_face++) {
+    size_t n_bytes = static_cast<size_t>(size) * size * image.n_channels;
+    unsigned char* data = static_cast<unsigned char*>(std::malloc(n_bytes));
+    faces.push_back(Image(size, size, image.n_channels, data));
+    faces.back().path = image.path;
+  }
+
+  std::vector<std::thread> threads;
+  for (int i_face = 0; i_face < 6; i_face++) {
+    threads.emplace_back(resample_face, std::cref(image), std::ref(faces[i_face]), i_face);
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return faces;
+}
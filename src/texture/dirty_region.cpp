@@ -0,0 +1,104 @@
+#include <limits>
+
+#include "texture/dirty_region.hpp"
+
+/**
+ * Fixed overhead of a sub-upload expressed in pixels (driver call & sync.)
+ * Two rectangles are merged when uploading the extra pixels of their bounding box is cheaper
+ */
+static const long COST_UPLOAD = 64 * 64;
+
+/* @param max_rects Cheapest pairs merged beyond this # of rectangles (bounds # of uploads per frame) */
+DirtyRegion::DirtyRegion(const Texture2D& texture, const Image& image, unsigned int max_rects):
+  m_texture(texture),
+  m_image(image.width, image.height, image.n_channels, image.data, false),
+  m_max_rects(max_rects)
+{
+}
+
+/**
+ * Wasted pixels in bounding box minus saved upload (negative => merging is worth it)
+ * Waste measured against union of both (overlap counted once)
+ */
+long DirtyRegion::get_merge_cost(const Rect& rect1, const Rect& rect2) {
+  Rect merged = rect1.merge(rect2);
+  long area_union = rect1.area() + rect2.area() - rect1.intersect(rect2).area();
+  long n_wasted = merged.area() - area_union;
+
+  return n_wasted - COST_UPLOAD;
+}
+
+/**
+ * Rectangle clipped to image, then merged repeatedly with those it's cheaper to upload with
+ * (rectangles only touching at a corner, e.g. along a diagonal stroke, are kept apart)
+ */
+void DirtyRegion::add(const Rect& rect) {
+  Rect dirty = rect.clip(m_image.width, m_image.height);
+  if (dirty.is_empty()) {
+    return;
+  }
+
+  bool is_merged = true;
+  while (is_merged) {
+    is_merged = false;
+
+    for (size_t i_rect = 0; i_rect < m_rects.size(); i_rect++) {
+      const Rect& other = m_rects[i_rect];
+      if (get_merge_cost(other, dirty) <= 0) {
+        dirty = dirty.merge(other);
+        m_rects.erase(m_rects.begin() + i_rect);
+        is_merged = true;
+        break;
+      }
+    }
+  }
+
+  m_rects.push_back(dirty);
+
+  while (m_rects.size() > m_max_rects) {
+    merge_cheapest();
+  }
+}
+
+/* Merge pair of rectangles with least cost (when too many rectangles are kept) */
+void DirtyRegion::merge_cheapest() {
+  long cost_min = std::numeric_limits<long>::max();
+  size_t i_min = 0, j_min = 1;
+
+  for (size_t i_rect = 0; i_rect < m_rects.size(); i_rect++) {
+    for (size_t j_rect = i_rect + 1; j_rect < m_rects.size(); j_rect++) {
+      long cost = get_merge_cost(m_rects[i_rect], m_rects[j_rect]);
+      if (cost < cost_min) {
+        cost_min = cost;
+        i_min = i_rect;
+        j_min = j_rect;
+      }
+    }
+  }
+
+  m_rects[i_min] = m_rects[i_min].merge(m_rects[j_min]);
+  m_rects.erase(m_rects.begin() + j_min);
+}
+
+/* Single bind for all rectangles */
+void DirtyRegion::flush() {
+  if (m_rects.empty()) {
+    return;
+  }
+
+  m_texture.set_subimages(m_image, m_rects);
+  m_rects.clear();
+}
+
+/* Discard pending rectangles (e.g. whole texture re-uploaded with `Texture2D::set_image()`) */
+void DirtyRegion::clear() {
+  m_rects.clear();
+}
+
+bool DirtyRegion::is_empty() const {
+  return m_rects.empty();
+}
+
+const std::vector<Rect>& DirtyRegion::get_rects() const {
+  return m_rects;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+#include "texture/environment_map.hpp"
+#include "texture/cubemap.hpp"
+#include "texture/ktx.hpp"
+#include "texture/color_space.hpp"
+#include "texture/texture_exception.hpp"
+
+namespace fs = std::filesystem;
+
+static const float PI = 3.14159265358979f;
+
+/* Low-discrepancy 2D point set: https://learnopengl.com/PBR/IBL/Specular-IBL */
+static glm::vec2 hammersley(unsigned int i, unsigned int n) {
+  unsigned int bits = i;
+  bits = (bits << 16u) | (bits >> 16u);
+  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xaaaaaaaau) >> 1u);
+  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xccccccccu) >> 2u);
+  bits = ((bits & 0x0f0f0f0fu) << 4u) | ((bits & 0xf0f0f0f0u) >> 4u);
+  bits = ((bits & 0x00ff00ffu) << 8u) | ((bits & 0xff00ff00u) >> 8u);
+
+  return glm::vec2(static_cast<float>(i) / n, bits * 2.3283064365386963e-10f);
+}
+
+/* Tangent-space vector to world space around normal */
+static glm::vec3 to_world(const glm::vec3& v, const glm::vec3& normal) {
+  glm::vec3 up = (std::abs(normal.z) < 0.999f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+  glm::vec3 tangent = glm::normalize(glm::cross(up, normal));
+  glm::vec3 bitangent = glm::cross(normal, tangent);
+
+  return tangent * v.x + bitangent * v.y + normal * v.z;
+}
+
+/* Fill faces of given size (one thread per face) with value computed from texel direction */
+static std::vector<Image> compute_faces(int size, const std::function<glm::vec3(const glm::vec3&)>& compute) {
+  std::vector<Image> faces;
+  for (int i_face = 0; i_face < 6; i_face++) {
+    unsigned char* data = static_cast<unsigned char*>(std::malloc(static_cast<size_t>(size) * size * 3));
+    faces.push_back(Image(size, size, 3, data));
+  }
+
+  auto compute_face = [&](int i_face) {
+    unsigned char* texel = faces[i_face].data;
+    for (int y = 0; y < size; y++) {
+      float t = 2.0f * (y + 0.5f) / size - 1.0f;
+      for (int x = 0; x < size; x++) {
+        float s = 2.0f * (x + 0.5f) / size - 1.0f;
+        glm::vec3 color = compute(glm::normalize(Cubemap::get_direction(i_face, s, t)));
+        *texel++ = ColorSpace::linear_to_srgb(color.r);
+        *texel++ = ColorSpace::linear_to_srgb(color.g);
+        *texel++ = ColorSpace::linear_to_srgb(color.b);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i_face = 0; i_face < 6; i_face++) {
+    threads.emplace_back(compute_face, i_face);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return faces;
+}
+
+/**
+ * Prefilter cubemap on the cpu (source read back from gpu)
+ * @param size_irradiance Faces size of irradiance cubemap (low-frequency => small)
+ * @param size_specular Faces size of specular cubemap's level 0 (roughness = 0)
+ * @param n_samples # of importance samples per texel
+ */
+EnvironmentMap::EnvironmentMap(Texture3D& source, int size_irradiance, int size_specular, int n_levels, int n_samples) {
+  set_levels(source);
+
+  irradiance = compute_faces(size_irradiance, [&](const glm::vec3& normal) {
+    return convolve_irradiance(normal, n_samples);
+  });
+
+  for (int level = 0; level < n_levels; level++) {
+    float roughness = (n_levels > 1) ? static_cast<float>(level) / (n_levels - 1) : 0.0f;
+    int size = std::max(1, size_specular >> level);
+
+    specular.push_back(compute_faces(size, [&](const glm::vec3& normal) {
+      return (level == 0) ? sample(normal, 0.0f) : convolve_specular(normal, roughness, n_samples);
+    }));
+  }
+
+  m_levels.clear();
+}
+
+/* Levels of a cached cubemap (`Ktx::load()` guarantees at least one level) */
+static std::vector<std::vector<Image>> load_cubemap(const std::string& path) {
+  std::vector<std::vector<Image>> levels = Ktx::load(path);
+  if (levels[0].size() != 6) {
+    for (const std::vector<Image>& faces : levels) {
+      for (const Image& face : faces) {
+        face.free();
+      }
+    }
+
+    throw TextureException("KTX file isn't a cubemap: " + path);
+  }
+
+  return levels;
+}
+
+/* Load prefiltered cubemaps cached by `save()` (throws `TextureException` if not cached or invalid) */
+EnvironmentMap::EnvironmentMap(const std::string& path_prefix):
+  irradiance(load_cubemap(path_prefix + "_irradiance.ktx")[0]),
+  specular(load_cubemap(path_prefix + "_specular.ktx"))
+{
+}
+
+bool EnvironmentMap::is_cached(const std::string& path_prefix) {
+  return fs::exists(path_prefix + "_irradiance.ktx") && fs::exists(path_prefix + "_specular.ktx");
+}
+
+/* Write both cubemaps next to each other (`<prefix>_irradiance.ktx` & `<prefix>_specular.ktx`) */
+void EnvironmentMap::save(const std::string& path_prefix) const {
+  Ktx::save(path_prefix + "_irradiance.ktx", { irradiance }, true);
+  Ktx::save(path_prefix + "_specular.ktx", specular, true);
+}
+
+/**
+ * Faces images freed after upload (call `save()` before)
+ * Texels stored in sRGB => sRGB internal format, so sampling returns linear radiance
+ */
+Texture3D EnvironmentMap::get_irradiance_texture(GLenum index) {
+  return Texture3D::from_levels({ irradiance }, index, Wrapping::STRETCH, true);
+}
+
+Texture3D EnvironmentMap::get_specular_texture(GLenum index) {
+  return Texture3D::from_levels(specular, index, Wrapping::STRETCH, true);
+}
+
+/* Only needed if textures weren't created */
+void EnvironmentMap::free() {
+  for (const Image& face : irradiance) {
+    face.free();
+  }
+
+  for (const std::vector<Image>& faces : specular) {
+    for (const Image& face : faces) {
+      face.free();
+    }
+  }
+}
+
+/* Read back source & build its mip chain in linear space (box filter) */
+void EnvironmentMap::set_levels(Texture3D& source) {
+  std::vector<Image> images = source.get_images(0);
+  Level level_0 = { images[0].width, {} };
+
+  for (const Image& image : images) {
+    std::vector<glm::vec3> face(static_cast<size_t>(image.width) * image.height);
+    for (size_t i_texel = 0; i_texel < face.size(); i_texel++) {
+      const unsigned char* texel = image.data + i_texel * image.n_channels;
+      int n_colors = std::min(image.n_channels, 3);
+      for (int i_channel = 0; i_channel < 3; i_channel++) {
+        face[i_texel][i_channel] = ColorSpace::srgb_to_linear(texel[std::min(i_channel, n_colors - 1)]);
+      }
+    }
+
+    level_0.faces.push_back(face);
+    image.free();
+  }
+
+  m_levels = { level_0 };
+  while (m_levels.back().size > 1) {
+    const Level& finer = m_levels.back();
+    Level coarser = { finer.size / 2, {} };
+
+    for (const std::vector<glm::vec3>& face_finer : finer.faces) {
+      std::vector<glm::vec3> face(static_cast<size_t>(coarser.size) * coarser.size);
+      for (int y = 0; y < coarser.size; y++) {
+        for (int x = 0; x < coarser.size; x++) {
+          const glm::vec3* row_0 = &face_finer[(2*y) * finer.size + 2*x];
+          const glm::vec3* row_1 = row_0 + finer.size;
+          face[y * coarser.size + x] = (row_0[0] + row_0[1] + row_1[0] + row_1[1]) * 0.25f;
+        }
+      }
+      coarser.faces.push_back(face);
+    }
+
+    m_levels.push_back(coarser);
+  }
+}
+
+/* Trilinear lookup in source mip chain */
+glm::vec3 EnvironmentMap::sample(const glm::vec3& direction, float level) const {
+  level = std::clamp(level, 0.0f, static_cast<float>(m_levels.size() - 1));
+  int level_0 = static_cast<int>(level);
+  int level_1 = std::min(level_0 + 1, static_cast<int>(m_levels.size() - 1));
+  float weight = level - level_0;
+
+  return sample_level(direction, level_0) * (1.0f - weight) + sample_level(direction, level_1) * weight;
+}
+
+/* Bilinear lookup in a level (face selected by major axis, clamped at face edges) */
+glm::vec3 EnvironmentMap::sample_level(const glm::vec3& direction, int level) const {
+  glm::vec3 abs_direction(std::abs(direction.x), std::abs(direction.y), std::abs(direction.z));
+  int i_face;
+  float sc, tc, ma;
+
+  if (abs_direction.x >= abs_direction.y && abs_direction.x >= abs_direction.z) {
+    i_face = (direction.x > 0.0f) ? 0 : 1;
+    ma = abs_direction.x;
+    sc = (direction.x > 0.0f) ? -direction.z : direction.z;
+    tc = -direction.y;
+  } else if (abs_direction.y >= abs_direction.z) {
+    i_face = (direction.y > 0.0f) ? 2 : 3;
+    ma = abs_direction.y;
+    sc = direction.x;
+    tc = (direction.y > 0.0f) ? direction.z : -direction.z;
+  } else {
+    i_face = (direction.z > 0.0f) ? 4 : 5;
+    ma = abs_direction.z;
+    sc = (direction.z > 0.0f) ? direction.x : -direction.x;
+    tc = -direction.y;
+  }
+
+  const Level& source = m_levels[level];
+  const std::vector<glm::vec3>& face = source.faces[i_face];
+  float x = std::clamp((sc / ma + 1.0f) * 0.5f * source.size - 0.5f, 0.0f, source.size - 1.0f);
+  float y = std::clamp((tc / ma + 1.0f) * 0.5f * source.size - 0.5f, 0.0f, source.size - 1.0f);
+  int x0 = static_cast<int>(x);
+  int y0 = static_cast<int>(y);
+  int x1 = std::min(x0 + 1, source.size - 1);
+  int y1 = std::min(y0 + 1, source.size - 1);
+  float dx = x - x0;
+  float dy = y - y0;
+
+  glm::vec3 top = face[y0 * source.size + x0] * (1.0f - dx) + face[y0 * source.size + x1] * dx;
+  glm::vec3 bottom = face[y1 * source.size + x0] * (1.0f - dx) + face[y1 * source.size + x1] * dx;
+  return top * (1.0f - dy) + bottom * dy;
+}
+
+/**
+ * Cosine-weighted average of incoming radiance around normal (irradiance / pi)
+ * Samples read from a level matching their solid angle (avoids aliasing with few samples)
+ */
+glm::vec3 EnvironmentMap::convolve_irradiance(const glm::vec3& normal, int n_samples) const {
+  float solid_angle_texel = 4.0f * PI / (6.0f * m_levels[0].size * m_levels[0].size);
+  glm::vec3 sum(0.0f);
+
+  for (int i_sample = 0; i_sample < n_samples; i_sample++) {
+    glm::vec2 xi = hammersley(i_sample, n_samples);
+    float phi = 2.0f * PI * xi.x;
+    float cos_theta = std::sqrt(1.0f - xi.y);
+    float sin_theta = std::sqrt(xi.y);
+
+    glm::vec3 light = to_world(glm::vec3(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta), normal);
+    float pdf = std::max(cos_theta / PI, 1e-4f);
+    float solid_angle_sample = 1.0f / (n_samples * pdf);
+    sum += sample(light, 0.5f * std::log2(solid_angle_sample / solid_angle_texel) + 1.0f);
+  }
+
+  return sum / static_cast<float>(n_samples);
+}
+
+/**
+ * GGX-weighted average of radiance around reflection direction (assumes view = normal)
+ * Importance sampling & mip selection from: https://learnopengl.com/PBR/IBL/Specular-IBL
+ */
+glm::vec3 EnvironmentMap::convolve_specular(const glm::vec3& normal, float roughness, int n_samples) const {
+  float alpha = roughness * roughness;
+  float solid_angle_texel = 4.0f * PI / (6.0f * m_levels[0].size * m_levels[0].size);
+  glm::vec3 sum(0.0f);
+  float weight = 0.0f;
+
+  for (int i_sample = 0; i_sample < n_samples; i_sample++) {
+    glm::vec2 xi = hammersley(i_sample, n_samples);
+    float phi = 2.0f * PI * xi.x;
+    float cos_theta = std::sqrt((1.0f - xi.y) / (1.0f + (alpha*alpha - 1.0f) * xi.y));
+    float sin_theta = std::sqrt(1.0f - cos_theta*cos_theta);
+
+    glm::vec3 halfway = to_world(glm::vec3(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta), normal);
+    glm::vec3 light = halfway * (2.0f * glm::dot(normal, halfway)) - normal;
+    float n_dot_l = glm::dot(normal, light);
+    if (n_dot_l <= 0.0f) {
+      continue;
+    }
+
+    // pdf of GGX distribution with view = normal
+    float denominator = cos_theta*cos_theta * (alpha*alpha - 1.0f) + 1.0f;
+    float distribution = alpha*alpha / (PI * denominator * denominator);
+    float pdf = std::max(distribution / 4.0f, 1e-4f);
+    float solid_angle_sample = 1.0f / (n_samples * pdf);
+
+    sum += sample(light, 0.5f * std::log2(solid_angle_sample / solid_angle_texel) + 1.0f) * n_dot_l;
+    weight += n_dot_l;
+  }
+
+  return (weight > 0.0f) ? sum / weight : sample(normal, 0.0f);
+}
@@ -0,0 +1,86 @@
+#include <unordered_map>
+
+#include "texture/feedback_pass.hpp"
+
+/* @param width/height Size of feedback buffer (e.g. 1/8 of screen size) */
+FeedbackPass::FeedbackPass(int width, int height):
+  m_framebuffer(),
+  m_texture(Image(width, height, 4, nullptr, false), GL_TEXTURE0, Wrapping::STRETCH),
+  m_buffers(2),
+  m_i_read(0),
+  m_i_write(0)
+{
+  m_texture.set_filters(GL_NEAREST, GL_NEAREST);
+  m_framebuffer.attach_texture(m_texture);
+}
+
+/* Redirect rendering of scene (with feedback shader) to low-res framebuffer */
+void FeedbackPass::begin() {
+  glGetIntegerv(GL_VIEWPORT, m_viewport);
+
+  m_framebuffer.bind();
+  glViewport(0, 0, m_framebuffer.width, m_framebuffer.height);
+  m_framebuffer.clear({ 0.0f, 0.0f, 0.0f, 0.0f });
+}
+
+/* Queue readback of feedback buffer (skipped if all buffers still in flight) */
+void FeedbackPass::end() {
+  m_framebuffer.unbind();
+  glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+
+  PixelBuffer& buffer = m_buffers[m_i_write];
+  if (buffer.is_pending()) {
+    return;
+  }
+
+  buffer.read(m_framebuffer, 0, 0, m_framebuffer.width, m_framebuffer.height, GL_RGBA);
+  m_i_write = (m_i_write + 1) % m_buffers.size();
+}
+
+/**
+ * Get finest mip level requested for each texture id in oldest finished readback
+ * @return false if no readback finished yet (requests left unchanged)
+ */
+bool FeedbackPass::get_requests(std::vector<FeedbackRequest>& requests) {
+  PixelBuffer& buffer = m_buffers[m_i_read];
+  if (!buffer.is_ready()) {
+    return false;
+  }
+
+  std::unordered_map<unsigned int, int> levels;
+  const unsigned char* pixels = buffer.map();
+  size_t n_pixels = m_framebuffer.width * m_framebuffer.height;
+
+  for (size_t i_pixel = 0; i_pixel < n_pixels; i_pixel++) {
+    const unsigned char* pixel = pixels + 4*i_pixel;
+    if (pixel[3] == 0) {
+      continue;
+    }
+
+    unsigned int id = pixel[0] | (pixel[1] << 8);
+    int level = pixel[2];
+    auto it = levels.find(id);
+    if (it == levels.end() || level < it->second) {
+      levels[id] = level;
+    }
+  }
+
+  buffer.unmap();
+  m_i_read = (m_i_read + 1) % m_buffers.size();
+
+  requests.clear();
+  for (const auto& item : levels) {
+    requests.push_back({ item.first, item.second });
+  }
+
+  return true;
+}
+
+void FeedbackPass::free() {
+  for (PixelBuffer& buffer : m_buffers) {
+    buffer.free();
+  }
+
+  m_texture.free();
+  m_framebuffer.free();
+}
@@ -22,24 +22,27 @@ Image::Image()
  * @param p Image path
  * @param flip: images (origin at upper-left) need to be flipped horizontally in OpenGL 3D (origin at bottom)
  * but not in ImGui because of 2D projection matrix used in project <imgui-example>
+ * @param desired_channels Force # of channels (0 to keep those in file)
  */
-Image::Image(const std::string& p, bool flip):
+Image::Image(const std::string& p, bool flip, int desired_channels):
   path(p),
   m_needs_free(true)
 {
-  // opengl origin at lower-left corner of image
-  if (flip) {
-    stbi_set_flip_vertically_on_load(true);
-  }
+  // opengl origin at lower-left corner of image (flag set per thread as images can be decoded in parallel)
+  stbi_set_flip_vertically_on_load_thread(flip);
 
   // load image using its path
   std::cout << "Loading image: " << path << "\n";
-  int desired_channels = 0;
   data = stbi_load(path.c_str(), &width, &height, &n_channels, desired_channels);
 
   if (data == nullptr) {
     throw ImageException();
   }
+
+  // stb returns # of channels in file even when converted
+  if (desired_channels != 0) {
+    n_channels = desired_channels;
+  }
 }
 
 /**
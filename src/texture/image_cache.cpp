@@ -0,0 +1,124 @@
+#include <functional>
+
+#include "texture/image_cache.hpp"
+
+namespace fs = std::filesystem;
+
+bool ImageCache::Key::operator==(const Key& other) const {
+  return path == other.path && flip == other.flip && desired_channels == other.desired_channels;
+}
+
+size_t ImageCache::KeyHash::operator()(const Key& key) const {
+  size_t hash = std::hash<std::string>()(key.path);
+  return hash ^ (std::hash<int>()(key.desired_channels * 2 + key.flip) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
+
+ImageCache::ImageCache(size_t n_bytes_budget):
+  m_n_bytes_budget(n_bytes_budget),
+  m_n_bytes(0),
+  m_n_hits(0),
+  m_n_misses(0)
+{
+}
+
+/* Single instance shared by all renderers (512 MB budget by default) */
+ImageCache& ImageCache::get() {
+  static ImageCache cache(512 * 1024 * 1024);
+  return cache;
+}
+
+/**
+ * Get decoded image from cache or load it (same params as `Image::Image()`)
+ * Cached image reloaded if file was modified since it was decoded
+ * Throws `ImageException` if image not found
+ */
+std::shared_ptr<const Image> ImageCache::load(const std::string& path, bool flip, int desired_channels) {
+  Key key = { path, flip, desired_channels };
+  std::error_code error;
+  fs::file_time_type time_modified = fs::last_write_time(path, error);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+
+    if (it != m_entries.end()) {
+      if (it->second.time_modified == time_modified) {
+        m_n_hits++;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.it_lru);
+        return it->second.image;
+      }
+
+      erase(key);
+    }
+
+    m_n_misses++;
+  }
+
+  // decode without holding the lock (other threads can load other images meanwhile)
+  Image image_owner(path, flip, desired_channels);
+  Image* image_view = new Image(image_owner.width, image_owner.height, image_owner.n_channels, image_owner.data, false);
+  image_view->path = path;
+
+  // pixels freed with last reference (cache entry or calling code)
+  std::shared_ptr<const Image> image(image_view, [image_owner](const Image* image_view) {
+    image_owner.free();
+    delete image_view;
+  });
+  size_t n_bytes = static_cast<size_t>(image->width) * image->height * image->n_channels;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(key);
+  if (it != m_entries.end()) {
+    // decoded concurrently by another thread
+    return it->second.image;
+  }
+
+  m_lru.push_front(key);
+  m_entries[key] = { image, time_modified, n_bytes, m_lru.begin() };
+  m_n_bytes += n_bytes;
+  evict();
+
+  return image;
+}
+
+/* Drop least-recently used images until budget is met (images still used by calling code stay alive) */
+void ImageCache::evict() {
+  while (m_n_bytes > m_n_bytes_budget && m_lru.size() > 1) {
+    erase(m_lru.back());
+  }
+}
+
+void ImageCache::erase(const Key& key) {
+  auto it = m_entries.find(key);
+  m_n_bytes -= it->second.n_bytes;
+  m_lru.erase(it->second.it_lru);
+  m_entries.erase(it);
+}
+
+void ImageCache::set_budget(size_t n_bytes_budget) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_n_bytes_budget = n_bytes_budget;
+  evict();
+}
+
+void ImageCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_lru.clear();
+  m_n_bytes = 0;
+}
+
+size_t ImageCache::get_n_bytes() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_n_bytes;
+}
+
+size_t ImageCache::get_n_hits() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_n_hits;
+}
+
+size_t ImageCache::get_n_misses() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_n_misses;
+}
@@ -0,0 +1,107 @@
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IMAGE_HASH_SSE2
+#endif
+
+#include "texture/image_hash.hpp"
+
+// primes from xxHash: https://github.com/Cyan4973/xxHash
+static const uint32_t PRIME32_1 = 0x9e3779b1u;
+static const uint32_t PRIME32_2 = 0x85ebca77u;
+static const uint64_t PRIME64_1 = 0x9e3779b185ebca87ull;
+static const uint64_t PRIME64_2 = 0xc2b2ae3d27d4eb4full;
+
+static uint32_t rotl32(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+static uint64_t rotl64(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+/* Final mix so that every input bit affects every output bit (splitmix64) */
+static uint64_t avalanche(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+#ifdef IMAGE_HASH_SSE2
+/* 32-bits lane-wise multiply (`_mm_mullo_epi32()` requires SSE4.1) */
+static __m128i mullo_epi32(__m128i a, __m128i b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+/**
+ * Hash buffer by blocks of 16 bytes (4 lanes of 4 bytes), then remaining bytes
+ * SSE2 & scalar paths give the same result
+ */
+uint64_t ImageHash::get(const unsigned char* data, size_t n_bytes) {
+  uint32_t lanes[4] = { PRIME32_1 + PRIME32_2, PRIME32_2, 0, 0u - PRIME32_1 };
+  size_t n_blocks = n_bytes / 16;
+
+#ifdef IMAGE_HASH_SSE2
+  __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+  const __m128i prime1 = _mm_set1_epi32(PRIME32_1);
+  const __m128i prime2 = _mm_set1_epi32(PRIME32_2);
+
+  for (size_t i_block = 0; i_block < n_blocks; i_block++) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16*i_block));
+    acc = _mm_add_epi32(acc, mullo_epi32(input, prime2));
+    acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+    acc = mullo_epi32(acc, prime1);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+#else
+  for (size_t i_block = 0; i_block < n_blocks; i_block++) {
+    for (size_t i_lane = 0; i_lane < 4; i_lane++) {
+      uint32_t input;
+      std::memcpy(&input, data + 16*i_block + 4*i_lane, 4);
+      lanes[i_lane] = rotl32(lanes[i_lane] + input * PRIME32_2, 13) * PRIME32_1;
+    }
+  }
+#endif
+
+  // merge lanes
+  uint64_t h = n_bytes * PRIME64_1;
+  for (size_t i_lane = 0; i_lane < 4; i_lane++) {
+    h ^= rotl32(lanes[i_lane], 7 * i_lane + 1);
+    h = rotl64(h, 27) * PRIME64_2;
+  }
+
+  // remaining bytes
+  for (size_t i_byte = 16*n_blocks; i_byte < n_bytes; i_byte++) {
+    h ^= data[i_byte] * PRIME64_1;
+    h = rotl64(h, 11) * PRIME64_2;
+  }
+
+  return avalanche(h);
+}
+
+/* Image dimensions hashed with pixels (same bytes with different sizes are different images) */
+uint64_t ImageHash::get(const Image& image) {
+  size_t n_bytes = static_cast<size_t>(image.width) * image.height * image.n_channels;
+  uint64_t hash_data = get(image.data, n_bytes);
+  uint64_t hash_size = avalanche((static_cast<uint64_t>(image.width) << 32) ^ (image.height << 4) ^ image.n_channels);
+
+  return combine({ hash_data, hash_size });
+}
+
+/* Order-dependent combination (e.g. of cubemap faces) */
+uint64_t ImageHash::combine(const std::vector<uint64_t>& hashes) {
+  uint64_t h = PRIME64_2;
+  for (uint64_t hash : hashes) {
+    h = avalanche(h ^ (hash + PRIME64_1 + (h << 6) + (h >> 2)));
+  }
+
+  return h;
+}
@@ -0,0 +1,75 @@
+#include <algorithm>
+
+#include "texture/image_loader.hpp"
+#include "texture/image_cache.hpp"
+
+ImageLoader::ImageLoader(unsigned int n_threads):
+  m_is_stopped(false)
+{
+  for (unsigned int i_thread = 0; i_thread < n_threads; i_thread++) {
+    m_threads.emplace_back(&ImageLoader::run, this);
+  }
+}
+
+/* Joins threads after finishing queued tasks (at program exit) */
+ImageLoader::~ImageLoader() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_stopped = true;
+  }
+
+  m_condition.notify_all();
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+/**
+ * Single instance leaving one core to the render thread (# of cores can be unknown, i.e. 0)
+ * Cache constructed first so it's destroyed after the loader (whose dtor runs queued tasks using it)
+ */
+ImageLoader& ImageLoader::get() {
+  ImageCache::get();
+  static unsigned int n_cores = std::thread::hardware_concurrency();
+  static ImageLoader loader(n_cores > 1 ? n_cores - 1 : 1);
+  return loader;
+}
+
+/**
+ * Queue decoding of image (same params as `Image::Image()`)
+ * `ImageException` rethrown by `get()` on returned future if image not found
+ */
+FutureImage ImageLoader::load(const std::string& path, bool flip, int desired_channels) {
+  auto task = std::make_shared<std::packaged_task<std::shared_ptr<const Image>()>>([=]() {
+    return ImageCache::get().load(path, flip, desired_channels);
+  });
+  FutureImage image = task->get_future().share();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push([task]() { (*task)(); });
+  }
+
+  m_condition.notify_one();
+  return image;
+}
+
+/* Loop run by each thread until loader destroyed */
+void ImageLoader::run() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_is_stopped || !m_tasks.empty(); });
+      if (m_is_stopped && m_tasks.empty()) {
+        return;
+      }
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop();
+    }
+
+    task();
+  }
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "glad/glad.h"
+#include "texture/ktx.hpp"
+#include "texture/texture_exception.hpp"
+
+static const unsigned char IDENTIFIER[12] = { 0xab, 0x4b, 0x54, 0x58, 0x20, 0x31, 0x31, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a };
+static const uint32_t ENDIANNESS = 0x04030201;
+
+/* KTX header fields following identifier */
+struct Header {
+  uint32_t endianness;
+  uint32_t gl_type;
+  uint32_t gl_type_size;
+  uint32_t gl_format;
+  uint32_t gl_internal_format;
+  uint32_t gl_base_internal_format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t depth;
+  uint32_t n_array_elements;
+  uint32_t n_faces;
+  uint32_t n_levels;
+  uint32_t n_bytes_key_value;
+};
+
+/* Rows padded to 4 bytes in KTX (like default GL_UNPACK_ALIGNMENT) */
+static size_t get_n_bytes_row(int width, int n_channels) {
+  return (width * n_channels + 3) & ~static_cast<size_t>(3);
+}
+
+static GLenum get_format(int n_channels) {
+  return (n_channels == 1) ? GL_RED : (n_channels == 3) ? GL_RGB : GL_RGBA;
+}
+
+/* No single-channel sRGB format in core OpenGL (red channel stays linear) */
+static GLenum get_internal_format(int n_channels, bool is_srgb) {
+  if (n_channels == 1) {
+    return GL_R8;
+  }
+
+  if (n_channels == 3) {
+    return is_srgb ? GL_SRGB8 : GL_RGB8;
+  }
+
+  return is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+}
+
+/**
+ * @param levels 1 image (2D texture) or 6 faces (cubemap) per level, finest first
+ * @param is_srgb Colors sRGB-encoded (written in header so other readers decode them)
+ */
+void Ktx::save(const std::string& path, const std::vector<std::vector<Image>>& levels, bool is_srgb) {
+  if (levels.empty() || levels[0].empty()) {
+    throw TextureException("KTX file without images: " + path);
+  }
+
+  const Image& image = levels[0][0];
+  Header header = {
+    ENDIANNESS, GL_UNSIGNED_BYTE, 1,
+    get_format(image.n_channels), get_internal_format(image.n_channels, is_srgb), get_format(image.n_channels),
+    static_cast<uint32_t>(image.width), static_cast<uint32_t>(image.height), 0,
+    0, static_cast<uint32_t>(levels[0].size()), static_cast<uint32_t>(levels.size()), 0
+  };
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw TextureException("KTX file cannot be written: " + path);
+  }
+
+  file.write(reinterpret_cast<const char*>(IDENTIFIER), sizeof(IDENTIFIER));
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<char> padding(4, 0);
+  for (const std::vector<Image>& faces : levels) {
+    // size of one face (faces sizes are multiples of 4 bytes as rows are padded)
+    size_t n_bytes_row = get_n_bytes_row(faces[0].width, faces[0].n_channels);
+    uint32_t n_bytes_face = n_bytes_row * faces[0].height;
+    file.write(reinterpret_cast<const char*>(&n_bytes_face), sizeof(n_bytes_face));
+
+    for (const Image& face : faces) {
+      size_t n_bytes_row_tight = face.width * face.n_channels;
+      for (int y = 0; y < face.height; y++) {
+        file.write(reinterpret_cast<const char*>(face.data + y * n_bytes_row_tight), n_bytes_row_tight);
+        file.write(padding.data(), n_bytes_row - n_bytes_row_tight);
+      }
+    }
+  }
+}
+
+/**
+ * Header of a 2D texture or cubemap with 8-bits red/rgb/rgba texels & at least one level stored
+ * (0 levels means mipmaps to generate in KTX, unsupported here as level 0 is indexed by calling code)
+ */
+static bool is_header_supported(const Header& header) {
+  const uint32_t SIZE_MAX_TEXTURE = 1 << 16;
+  bool is_format_supported = header.gl_format == GL_RED || header.gl_format == GL_RGB || header.gl_format == GL_RGBA;
+
+  return header.endianness == ENDIANNESS && header.gl_type == GL_UNSIGNED_BYTE && header.gl_type_size == 1 &&
+         is_format_supported &&
+         header.width > 0 && header.width <= SIZE_MAX_TEXTURE && header.height > 0 && header.height <= SIZE_MAX_TEXTURE &&
+         header.depth == 0 && header.n_array_elements == 0 &&
+         (header.n_faces == 1 || header.n_faces == 6) &&
+         header.n_levels > 0 && header.n_levels <= 32;
+}
+
+/**
+ * @return Images allocated with malloc, rows tightly packed (freed with `Image::free()`), at least one level
+ * Throws `TextureException` if file missing, not an uncompressed 8-bits KTX, or with inconsistent sizes
+ */
+std::vector<std::vector<Image>> Ktx::load(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  unsigned char identifier[12];
+  Header header;
+
+  if (!file.read(reinterpret_cast<char*>(identifier), sizeof(identifier)) ||
+      !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0 ||
+      !is_header_supported(header)) {
+    throw TextureException("Invalid KTX file: " + path);
+  }
+
+  int n_channels = (header.gl_format == GL_RED) ? 1 : (header.gl_format == GL_RGB) ? 3 : 4;
+  file.seekg(header.n_bytes_key_value, std::ios::cur);
+
+  std::vector<std::vector<Image>> levels;
+  for (uint32_t level = 0; level < header.n_levels; level++) {
+    int width = std::max(1u, header.width >> level);
+    int height = std::max(1u, header.height >> level);
+    size_t n_bytes_row = get_n_bytes_row(width, n_channels);
+    size_t n_bytes_row_tight = width * n_channels;
+
+    uint32_t n_bytes_face;
+    if (!file.read(reinterpret_cast<char*>(&n_bytes_face), sizeof(n_bytes_face)) || n_bytes_face != n_bytes_row * height) {
+      break;
+    }
+
+    std::vector<Image> faces;
+    std::vector<char> row(n_bytes_row);
+    for (uint32_t i_face = 0; i_face < header.n_faces; i_face++) {
+      unsigned char* data = static_cast<unsigned char*>(std::malloc(n_bytes_row_tight * height));
+      for (int y = 0; y < height; y++) {
+        file.read(row.data(), n_bytes_row);
+        std::memcpy(data + y * n_bytes_row_tight, row.data(), n_bytes_row_tight);
+      }
+
+      faces.push_back(Image(width, height, n_channels, data));
+      faces.back().path = path;
+    }
+
+    levels.push_back(faces);
+  }
+
+  if (!file || levels.size() != header.n_levels) {
+    for (const std::vector<Image>& faces : levels) {
+      for (const Image& face : faces) {
+        face.free();
+      }
+    }
+
+    throw TextureException("Truncated or inconsistent KTX file: " + path);
+  }
+
+  return levels;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+
+#include "texture/page_manager.hpp"
+
+PageManager::PageManager(unsigned int n_slots):
+  m_n_slots(n_slots)
+{
+  // slots handed out in increasing order
+  m_free_slots.reserve(n_slots);
+  for (unsigned int i_slot = n_slots; i_slot > 0; i_slot--) {
+    m_free_slots.push_back(i_slot - 1);
+  }
+}
+
+/**
+ * Get slot of page with given key, allocating it (and evicting lru page if needed) when not resident
+ * Also marks the page as most recently used
+ */
+PageSlot PageManager::acquire(uint64_t key) {
+  PageSlot page_slot = { 0, false, false, 0 };
+
+  if (touch(key)) {
+    page_slot.slot = m_entries.at(key).slot;
+    return page_slot;
+  }
+
+  page_slot.is_new = true;
+
+  if (m_free_slots.empty()) {
+    // reuse slot of least-recently used page
+    uint64_t key_evicted = m_lru.back();
+    page_slot.has_evicted = true;
+    page_slot.key_evicted = key_evicted;
+    release(key_evicted);
+  }
+
+  page_slot.slot = m_free_slots.back();
+  m_free_slots.pop_back();
+  m_lru.push_front(key);
+  m_entries[key] = { page_slot.slot, m_lru.begin() };
+
+  return page_slot;
+}
+
+/**
+ * Acquire slots for pages requested in a frame that aren't resident yet, & load them with `load()`
+ * All resident requested pages are marked as recently used first, so a page loaded this frame
+ * never evicts a page requested in the same frame (which would be reloaded right after)
+ * @param n_loads_max Budget of pages loaded per call (remaining ones requested again next frame)
+ */
+void PageManager::load_missing(const std::vector<uint64_t>& keys, unsigned int n_loads_max,
+                               const std::function<void(uint64_t key, const PageSlot& page_slot)>& load) {
+  std::vector<uint64_t> keys_missing;
+  for (uint64_t key : keys) {
+    if (!touch(key)) {
+      keys_missing.push_back(key);
+    }
+  }
+
+  unsigned int n_loads = std::min<size_t>(keys_missing.size(), n_loads_max);
+  for (unsigned int i_key = 0; i_key < n_loads; i_key++) {
+    load(keys_missing[i_key], acquire(keys_missing[i_key]));
+  }
+}
+
+/**
+ * Mark page as most recently used
+ * @return false if page not resident
+ */
+bool PageManager::touch(uint64_t key) {
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    return false;
+  }
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.it_lru);
+  return true;
+}
+
+bool PageManager::is_resident(uint64_t key) const {
+  return m_entries.find(key) != m_entries.end();
+}
+
+/* Free slot occupied by page (if resident) */
+void PageManager::release(uint64_t key) {
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    return;
+  }
+
+  m_free_slots.push_back(it->second.slot);
+  m_lru.erase(it->second.it_lru);
+  m_entries.erase(it);
+}
+
+unsigned int PageManager::get_n_resident() const {
+  return m_entries.size();
+}
+
+unsigned int PageManager::get_n_slots() const {
+  return m_n_slots;
+}
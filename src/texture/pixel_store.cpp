@@ -0,0 +1,47 @@
+#include <initializer_list>
+
+#include "texture/pixel_store.hpp"
+
+/* Save current parameters for pack (`glGetTexImage()`, `glReadPixels()`) or unpack (`glTex*Image*()`) */
+PixelStore::PixelStore(bool is_pack):
+  m_is_pack(is_pack)
+{
+  glGetIntegerv(get_name(GL_PACK_ALIGNMENT, GL_UNPACK_ALIGNMENT), &m_alignment);
+  glGetIntegerv(get_name(GL_PACK_ROW_LENGTH, GL_UNPACK_ROW_LENGTH), &m_row_length);
+  glGetIntegerv(get_name(GL_PACK_SKIP_PIXELS, GL_UNPACK_SKIP_PIXELS), &m_skip_pixels);
+  glGetIntegerv(get_name(GL_PACK_SKIP_ROWS, GL_UNPACK_SKIP_ROWS), &m_skip_rows);
+  set_rect(0, 0, 0);
+}
+
+GLenum PixelStore::get_name(GLenum name_pack, GLenum name_unpack) const {
+  return m_is_pack ? name_pack : name_unpack;
+}
+
+void PixelStore::set_alignment(GLint alignment) {
+  glPixelStorei(get_name(GL_PACK_ALIGNMENT, GL_UNPACK_ALIGNMENT), alignment);
+}
+
+/* Transfer a rectangle inside a bigger image (rows of `row_length` pixels) */
+void PixelStore::set_rect(GLint row_length, GLint skip_pixels, GLint skip_rows) {
+  glPixelStorei(get_name(GL_PACK_ROW_LENGTH, GL_UNPACK_ROW_LENGTH), row_length);
+  glPixelStorei(get_name(GL_PACK_SKIP_PIXELS, GL_UNPACK_SKIP_PIXELS), skip_pixels);
+  glPixelStorei(get_name(GL_PACK_SKIP_ROWS, GL_UNPACK_SKIP_ROWS), skip_rows);
+}
+
+void PixelStore::restore() const {
+  glPixelStorei(get_name(GL_PACK_ALIGNMENT, GL_UNPACK_ALIGNMENT), m_alignment);
+  glPixelStorei(get_name(GL_PACK_ROW_LENGTH, GL_UNPACK_ROW_LENGTH), m_row_length);
+  glPixelStorei(get_name(GL_PACK_SKIP_PIXELS, GL_UNPACK_SKIP_PIXELS), m_skip_pixels);
+  glPixelStorei(get_name(GL_PACK_SKIP_ROWS, GL_UNPACK_SKIP_ROWS), m_skip_rows);
+}
+
+/* Largest alignment (<= 8) rows of given size in bytes are multiple of (e.g. 1 for odd-width rgb images) */
+GLint PixelStore::get_alignment(size_t n_bytes_row) {
+  for (GLint alignment : { 8, 4, 2 }) {
+    if (n_bytes_row % alignment == 0) {
+      return alignment;
+    }
+  }
+
+  return 1;
+}
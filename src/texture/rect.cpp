@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "texture/rect.hpp"
+
+Rect::Rect():
+  Rect(0, 0, 0, 0)
+{
+}
+
+Rect::Rect(int x, int y, int w, int h):
+  x(x),
+  y(y),
+  width(w),
+  height(h)
+{
+}
+
+bool Rect::is_empty() const {
+  return width <= 0 || height <= 0;
+}
+
+long Rect::area() const {
+  return is_empty() ? 0 : static_cast<long>(width) * height;
+}
+
+/* Overlapping or sharing an edge */
+bool Rect::touches(const Rect& other) const {
+  return x <= other.x + other.width && other.x <= x + width &&
+         y <= other.y + other.height && other.y <= y + height;
+}
+
+/* @return Bounding rectangle of both (empty rectangles ignored) */
+Rect Rect::merge(const Rect& other) const {
+  if (is_empty()) {
+    return other;
+  }
+  if (other.is_empty()) {
+    return *this;
+  }
+
+  int x_min = std::min(x, other.x);
+  int y_min = std::min(y, other.y);
+  int x_max = std::max(x + width, other.x + other.width);
+  int y_max = std::max(y + height, other.y + other.height);
+
+  return Rect(x_min, y_min, x_max - x_min, y_max - y_min);
+}
+
+/* @return Overlap of both (empty if they don't overlap) */
+Rect Rect::intersect(const Rect& other) const {
+  int x_min = std::max(x, other.x);
+  int y_min = std::max(y, other.y);
+  int x_max = std::min(x + width, other.x + other.width);
+  int y_max = std::min(y + height, other.y + other.height);
+
+  return Rect(x_min, y_min, std::max(x_max - x_min, 0), std::max(y_max - y_min, 0));
+}
+
+/* Intersection with image of given size (e.g. brush stamp overlapping the canvas border) */
+Rect Rect::clip(int w, int h) const {
+  int x_min = std::max(x, 0);
+  int y_min = std::max(y, 0);
+  int x_max = std::min(x + width, w);
+  int y_max = std::min(y + height, h);
+
+  return Rect(x_min, y_min, std::max(x_max - x_min, 0), std::max(y_max - y_min, 0));
+}
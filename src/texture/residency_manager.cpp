@@ -0,0 +1,230 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "texture/residency_manager.hpp"
+#include "texture/pixel_store.hpp"
+
+namespace fs = std::filesystem;
+
+/**
+ * Set `Texture::residency_manager` to this manager to track textures usage
+ * @param n_bytes_budget Max gpu memory occupied by registered textures
+ * @param dir_spill Directory where evicted textures are saved (kept in ram if empty)
+ */
+ResidencyManager::ResidencyManager(size_t n_bytes_budget, const std::string& dir_spill):
+  m_n_bytes_budget(n_bytes_budget),
+  m_n_bytes(0),
+  m_i_frame(0),
+  m_dir_spill(dir_spill)
+{
+  if (!m_dir_spill.empty()) {
+    fs::create_directories(m_dir_spill);
+  }
+}
+
+/**
+ * Start tracking texture (size queried from its allocated levels)
+ * Only 8-bits color textures are managed (render targets with integer, float or depth formats are rewritten each frame)
+ */
+void ResidencyManager::add(Texture& texture) {
+  if (m_entries.find(texture.id) != m_entries.end()) {
+    return;
+  }
+
+  if (texture.format != GL_RED && texture.format != GL_RGB && texture.format != GL_RGBA) {
+    std::cout << "Texture not managed (format not 8-bits color): " << texture.name << '\n';
+    return;
+  }
+
+  size_t n_bytes = texture.get_n_bytes();
+  m_entries[texture.id] = { texture.id, texture.type, texture.format, n_bytes, m_i_frame, true, {} };
+  m_n_bytes += n_bytes;
+}
+
+/* Called on `Texture::free()` */
+void ResidencyManager::remove(const Texture& texture) {
+  auto it = m_entries.find(texture.id);
+  if (it == m_entries.end()) {
+    return;
+  }
+
+  if (it->second.is_resident) {
+    m_n_bytes -= it->second.n_bytes;
+  } else if (!m_dir_spill.empty()) {
+    fs::remove(get_path_spill(texture.id));
+  }
+
+  m_entries.erase(it);
+}
+
+/**
+ * Called when a registered texture is reallocated (e.g. by `Texture2D::set_image()`) as its size is cached
+ * Levels saved on eviction are discarded (superseded by the new storage)
+ */
+void ResidencyManager::update(Texture& texture) {
+  if (m_entries.find(texture.id) == m_entries.end()) {
+    return;
+  }
+
+  remove(texture);
+  add(texture);
+}
+
+/* Mark texture as used in current frame & reload it if evicted */
+void ResidencyManager::touch(const Texture& texture) {
+  auto it = m_entries.find(texture.id);
+  if (it == m_entries.end()) {
+    return;
+  }
+
+  Entry& entry = it->second;
+  entry.frame_last_used = m_i_frame;
+  if (!entry.is_resident) {
+    reload(entry);
+  }
+}
+
+/**
+ * Called once at the end of each frame
+ * Evicts least-recently used textures until budget is met (textures used in current frame are kept)
+ */
+void ResidencyManager::next_frame() {
+  while (m_n_bytes > m_n_bytes_budget) {
+    Entry* entry_lru = nullptr;
+    for (auto& item : m_entries) {
+      Entry& entry = item.second;
+      if (entry.is_resident && entry.frame_last_used < m_i_frame &&
+          (entry_lru == nullptr || entry.frame_last_used < entry_lru->frame_last_used)) {
+        entry_lru = &entry;
+      }
+    }
+
+    if (entry_lru == nullptr) {
+      break;
+    }
+
+    evict(*entry_lru);
+  }
+
+  m_i_frame++;
+}
+
+/* Copy all levels to cpu (then disk if spilling) & release their gpu storage */
+void ResidencyManager::evict(Entry& entry) {
+  std::vector<GLenum> targets = { entry.type };
+  if (entry.type == GL_TEXTURE_CUBE_MAP) {
+    targets.clear();
+    for (size_t i_face = 0; i_face < 6; i_face++) {
+      targets.push_back(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_face);
+    }
+  }
+
+  int n_channels = (entry.format == GL_RED) ? 1 : (entry.format == GL_RGB) ? 3 : 4;
+  glBindTexture(entry.type, entry.id);
+  PixelStore pixel_store(true);
+  pixel_store.set_alignment(1);
+
+  GLint n_levels = Texture::get_n_levels_max(entry.type);
+
+  for (GLenum target : targets) {
+    for (GLint level = 0; level < n_levels; level++) {
+      Level copy = { target, level, 0, 0, 0, 0, {} };
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &copy.width);
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &copy.height);
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_DEPTH, &copy.depth);
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_INTERNAL_FORMAT, &copy.internal_format);
+      if (copy.width == 0) {
+        continue;
+      }
+
+      copy.data.resize(static_cast<size_t>(copy.width) * copy.height * copy.depth * n_channels);
+      glGetTexImage(target, level, entry.format, GL_UNSIGNED_BYTE, copy.data.data());
+      entry.levels.push_back(std::move(copy));
+    }
+  }
+
+  // respecify levels with empty images to release their storage (volumes & arrays have 3D levels)
+  for (const Level& level : entry.levels) {
+    if (entry.type == GL_TEXTURE_2D_ARRAY || entry.type == GL_TEXTURE_3D) {
+      glTexImage3D(level.target, level.level, level.internal_format, 0, 0, 0, 0, entry.format, GL_UNSIGNED_BYTE, NULL);
+    } else {
+      glTexImage2D(level.target, level.level, level.internal_format, 0, 0, 0, entry.format, GL_UNSIGNED_BYTE, NULL);
+    }
+  }
+
+  pixel_store.restore();
+  glBindTexture(entry.type, 0);
+
+  if (!m_dir_spill.empty()) {
+    std::ofstream file(get_path_spill(entry.id), std::ios::binary);
+    for (Level& level : entry.levels) {
+      file.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+      level.data = std::vector<unsigned char>();
+    }
+  }
+
+  entry.is_resident = false;
+  m_n_bytes -= entry.n_bytes;
+}
+
+/* Re-upload levels saved on eviction */
+void ResidencyManager::reload(Entry& entry) {
+  if (!m_dir_spill.empty()) {
+    int n_channels = (entry.format == GL_RED) ? 1 : (entry.format == GL_RGB) ? 3 : 4;
+    std::ifstream file(get_path_spill(entry.id), std::ios::binary);
+    if (!file) {
+      std::cout << "Evicted texture not found on disk: " << entry.id << '\n';
+      return;
+    }
+
+    for (Level& level : entry.levels) {
+      level.data.resize(static_cast<size_t>(level.width) * level.height * level.depth * n_channels);
+      file.read(reinterpret_cast<char*>(level.data.data()), level.data.size());
+    }
+  }
+
+  glBindTexture(entry.type, entry.id);
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(1);
+
+  for (const Level& level : entry.levels) {
+    if (entry.type == GL_TEXTURE_2D_ARRAY || entry.type == GL_TEXTURE_3D) {
+      glTexImage3D(level.target, level.level, level.internal_format, level.width, level.height, level.depth, 0,
+                   entry.format, GL_UNSIGNED_BYTE, level.data.data());
+    } else {
+      glTexImage2D(level.target, level.level, level.internal_format, level.width, level.height, 0,
+                   entry.format, GL_UNSIGNED_BYTE, level.data.data());
+    }
+  }
+
+  pixel_store.restore();
+  glBindTexture(entry.type, 0);
+
+  if (!m_dir_spill.empty()) {
+    fs::remove(get_path_spill(entry.id));
+  }
+
+  entry.levels.clear();
+  entry.is_resident = true;
+  m_n_bytes += entry.n_bytes;
+}
+
+std::string ResidencyManager::get_path_spill(GLuint id) const {
+  return (fs::path(m_dir_spill) / ("texture_" + std::to_string(id) + ".bin")).string();
+}
+
+bool ResidencyManager::is_resident(const Texture& texture) const {
+  auto it = m_entries.find(texture.id);
+  return it == m_entries.end() || it->second.is_resident;
+}
+
+/* Gpu memory occupied by resident registered textures */
+size_t ResidencyManager::get_n_bytes() const {
+  return m_n_bytes;
+}
+
+/* Budget enforced at next call to `next_frame()` */
+void ResidencyManager::set_budget(size_t n_bytes_budget) {
+  m_n_bytes_budget = n_bytes_budget;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+
+#include "texture/streaming_manager.hpp"
+
+StreamingManager::StreamingManager(unsigned int n_uploads_max, unsigned int n_updates_unused):
+  m_n_uploads_max(n_uploads_max),
+  m_n_updates_unused(n_updates_unused),
+  m_i_update(0),
+  m_n_bytes(0)
+{
+}
+
+/**
+ * Register texture with only its coarsest level resident
+ * @param n_levels # of mip levels provided by `load_level`
+ * @return Id to write in feedback pass & to retrieve texture with `get_texture()`
+ */
+unsigned int StreamingManager::add(const LevelLoader& load_level, int n_levels, GLenum index, Wrapping wrapping) {
+  int level_coarsest = n_levels - 1;
+  Image image = load_level(level_coarsest);
+  size_t n_bytes = image.width * image.height * image.n_channels;
+
+  Entry entry = {
+    Texture2D::from_level(image, level_coarsest, index, wrapping),
+    load_level,
+    n_levels,
+    level_coarsest,
+    level_coarsest,
+    m_i_update,
+    std::vector<size_t>(n_levels, 0),
+  };
+  entry.n_bytes_levels[level_coarsest] = n_bytes;
+  m_n_bytes += n_bytes;
+
+  m_entries.push_back(entry);
+  return m_entries.size();
+}
+
+/* Copy shares gpu texture with manager (resident levels change after each `update()`) */
+Texture2D StreamingManager::get_texture(unsigned int id) const {
+  return m_entries[id - 1].texture;
+}
+
+/**
+ * Upload/evict mip levels according to requests from last finished feedback readback
+ * @param requests Finest level needed on screen for each visible texture
+ */
+void StreamingManager::update(const std::vector<FeedbackRequest>& requests) {
+  m_i_update++;
+
+  for (const FeedbackRequest& request : requests) {
+    if (request.id == 0 || request.id > m_entries.size()) {
+      continue;
+    }
+
+    Entry& entry = m_entries[request.id - 1];
+    entry.level_desired = std::clamp(request.level, 0, entry.n_levels - 1);
+    entry.update_last_requested = m_i_update;
+  }
+
+  unsigned int n_uploads = 0;
+  for (Entry& entry : m_entries) {
+    if (m_i_update - entry.update_last_requested > m_n_updates_unused) {
+      entry.level_desired = entry.n_levels - 1;
+    }
+
+    if (entry.level_desired < entry.level_resident && n_uploads < m_n_uploads_max) {
+      load_finer_level(entry);
+      n_uploads++;
+    } else if (entry.level_desired > entry.level_resident) {
+      evict_finest_level(entry);
+    }
+  }
+}
+
+void StreamingManager::load_finer_level(Entry& entry) {
+  int level = entry.level_resident - 1;
+  Image image = entry.load_level(level);
+  size_t n_bytes = image.width * image.height * image.n_channels;
+
+  entry.texture.set_level(image, level);
+  entry.texture.set_levels_range(level, entry.n_levels - 1);
+  entry.level_resident = level;
+  entry.n_bytes_levels[level] = n_bytes;
+  m_n_bytes += n_bytes;
+}
+
+void StreamingManager::evict_finest_level(Entry& entry) {
+  int level = entry.level_resident;
+
+  // restrict sampling to remaining levels before freeing storage
+  entry.texture.set_levels_range(level + 1, entry.n_levels - 1);
+  entry.texture.free_level(level);
+  entry.level_resident = level + 1;
+  m_n_bytes -= entry.n_bytes_levels[level];
+  entry.n_bytes_levels[level] = 0;
+}
+
+/* Gpu memory used by resident levels of all streamed textures */
+size_t StreamingManager::get_n_bytes() const {
+  return m_n_bytes;
+}
+
+void StreamingManager::free() {
+  for (const Entry& entry : m_entries) {
+    entry.texture.free();
+  }
+
+  m_entries.clear();
+  m_n_bytes = 0;
+}
@@ -1,9 +1,12 @@
 #include <filesystem>
 
 #include "texture/texture.hpp"
+#include "texture/residency_manager.hpp"
 
 namespace fs = std::filesystem;
 
+ResidencyManager* Texture::residency_manager = nullptr;
+
 /**
  * Default constructor: fields not init on purpose (to avoid that texture unit of default normal tex hides that of diffuse in `ModelRenderer`)
  * also needed because lvalue in assignment `map[key] = value` (source: models/models.cpp) evals to a reference
@@ -14,10 +17,11 @@ Texture::Texture()
 {}
 
 /* Used by children constructors to init this class's members */
-Texture::Texture(GLuint t, GLenum index, Wrapping wrapping, const std::string& path):
+Texture::Texture(GLuint t, GLenum index, Wrapping wrapping, const std::string& path, bool is_srgb):
   type(t),
   m_index(index),
   m_wrapping(wrapping),
+  m_is_srgb(is_srgb),
   name(fs::path(path).stem())
 {
 }
@@ -50,6 +54,11 @@ void Texture::configure() {
   glTexParameteri(type, GL_TEXTURE_WRAP_S, wrapping_method);
   glTexParameteri(type, GL_TEXTURE_WRAP_T, wrapping_method);
 
+  // 3rd axis of volumes
+  if (type == GL_TEXTURE_3D) {
+    glTexParameteri(type, GL_TEXTURE_WRAP_R, wrapping_method);
+  }
+
   unbind();
 }
 
@@ -63,6 +72,10 @@ void Texture::unbind() {
 
 /* Attach texture object id to texture unit m_index before `Renderer::draw()` */
 void Texture::attach() {
+  if (residency_manager != nullptr) {
+    residency_manager->touch(*this);
+  }
+
   glActiveTexture(m_index);
   bind();
 }
@@ -72,17 +85,28 @@ GLenum Texture::get_index() const {
   return m_index - GL_TEXTURE0;
 }
 
-/* Get texture format from # of channels */
+/* Texture unit changed when same texture object is shared (e.g. by `TextureRegistry`) */
+void Texture::set_index(GLenum index) {
+  m_index = index;
+}
+
+/**
+ * Get texture format from # of channels
+ * sRGB textures get a sized sRGB internal format (no single-channel sRGB format in core profile => kept linear)
+ */
 void Texture::set_format(int n_channels) {
   switch (n_channels) {
     case 1:
       format = GL_RED;
+      m_internal_format = GL_RED;
       break;
     case 3:
       format = GL_RGB;
+      m_internal_format = m_is_srgb ? GL_SRGB8 : GL_RGB;
       break;
     default:
       format = GL_RGBA;
+      m_internal_format = m_is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA;
   }
 }
 
@@ -92,9 +116,13 @@ int Texture::get_n_channels() const {
 
   switch (format) {
     case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_STENCIL:
       n = 1;
       break;
     case GL_RGB:
+    case GL_RGB_INTEGER:
       n = 3;
       break;
     default:
@@ -104,9 +132,169 @@ int Texture::get_n_channels() const {
   return n;
 }
 
+/**
+ * Generate mip chain from level 0 & sample it with trilinear filtering
+ * Used by `Texture2DArray` for textures minified at a distance
+ */
+void Texture::generate_mipmaps() {
+  bind();
+  glGenerateMipmap(type);
+  glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  unbind();
+}
+
+/* Also needed by `Framebuffer` to enable sRGB encoding when rendering to texture */
+bool Texture::is_srgb() const {
+  return m_is_srgb;
+}
+
+/**
+ * Override interpolation set in `configure()`
+ * GL_NEAREST needed for textures storing indices (e.g. page table in `VirtualTexture`)
+ */
+void Texture::set_filters(GLint filter_min, GLint filter_mag) {
+  bind();
+  glTexParameteri(type, GL_TEXTURE_MIN_FILTER, filter_min);
+  glTexParameteri(type, GL_TEXTURE_MAG_FILTER, filter_mag);
+  unbind();
+}
+
+/**
+ * Restrict sampling to given mip levels (levels outside range may be missing without making texture incomplete)
+ * @param level_base Finest level sampled
+ * @param level_max Coarsest level sampled
+ */
+void Texture::set_levels_range(GLint level_base, GLint level_max) {
+  bind();
+  glTexParameteri(type, GL_TEXTURE_BASE_LEVEL, level_base);
+  glTexParameteri(type, GL_TEXTURE_MAX_LEVEL, level_max);
+  unbind();
+}
+
+/**
+ * # of mip levels a texture of given type can have (querying levels beyond raises GL_INVALID_VALUE)
+ * e.g. 15 levels for a max size of 16384
+ */
+GLint Texture::get_n_levels_max(GLenum type) {
+  GLenum parameter = (type == GL_TEXTURE_3D) ? GL_MAX_3D_TEXTURE_SIZE :
+                     (type == GL_TEXTURE_CUBE_MAP) ? GL_MAX_CUBE_MAP_TEXTURE_SIZE : GL_MAX_TEXTURE_SIZE;
+  GLint size_max = 0;
+  glGetIntegerv(parameter, &size_max);
+
+  GLint n_levels = 0;
+  while (size_max > 0) {
+    size_max >>= 1;
+    n_levels++;
+  }
+
+  return n_levels;
+}
+
+/* Size of a texel on the gpu for common internal formats (unsized formats assumed to be 8-bits per channel) */
+size_t Texture::get_n_bytes_texel(GLint internal_format) {
+  switch (internal_format) {
+    case GL_RED:
+    case GL_R8:
+    case GL_R8UI:
+    case GL_R8I:
+      return 1;
+    case GL_RG:
+    case GL_RG8:
+    case GL_R16:
+    case GL_R16F:
+    case GL_R16UI:
+    case GL_R16I:
+    case GL_DEPTH_COMPONENT16:
+      return 2;
+    case GL_RGB:
+    case GL_RGB8:
+    case GL_SRGB8:
+      return 3;
+    case GL_RG16F:
+    case GL_RG16UI:
+    case GL_RG16I:
+    case GL_R32F:
+    case GL_R32UI:
+    case GL_R32I:
+    case GL_RGB10_A2:
+    case GL_R11F_G11F_B10F:
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH_STENCIL:
+    case GL_DEPTH24_STENCIL8:
+      return 4;
+    case GL_RGB16F:
+    case GL_RGB16UI:
+    case GL_RGB16I:
+      return 6;
+    case GL_RGBA16:
+    case GL_RGBA16F:
+    case GL_RGBA16UI:
+    case GL_RGBA16I:
+    case GL_RG32F:
+    case GL_RG32UI:
+    case GL_RG32I:
+    case GL_DEPTH32F_STENCIL8:
+      return 8;
+    case GL_RGB32F:
+    case GL_RGB32UI:
+    case GL_RGB32I:
+      return 12;
+    case GL_RGBA32F:
+    case GL_RGBA32UI:
+    case GL_RGBA32I:
+      return 16;
+    default:
+      // GL_RGBA, GL_RGBA8, GL_SRGB8_ALPHA8...
+      return 4;
+  }
+}
+
+/**
+ * Gpu memory used by all allocated levels (& faces for cubemaps)
+ * Queried from opengl as levels can be missing (e.g. streamed textures)
+ */
+size_t Texture::get_n_bytes() {
+  std::vector<GLenum> targets = { type };
+  if (type == GL_TEXTURE_CUBE_MAP) {
+    targets.clear();
+    for (size_t i_face = 0; i_face < 6; i_face++) {
+      targets.push_back(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_face);
+    }
+  }
+
+  GLint n_levels = get_n_levels_max(type);
+  size_t n_bytes = 0;
+  bind();
+
+  for (GLenum target : targets) {
+    for (GLint level = 0; level < n_levels; level++) {
+      GLint width = 0, height = 0, depth = 0, internal_format = 0;
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+      if (width == 0) {
+        continue;
+      }
+
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_DEPTH, &depth);
+      glGetTexLevelParameteriv(target, level, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+      n_bytes += static_cast<size_t>(width) * height * depth * get_n_bytes_texel(internal_format);
+    }
+  }
+
+  unbind();
+
+  return n_bytes;
+}
+
 /**
  * Delete texture
  */
 void Texture::free() const {
+  if (residency_manager != nullptr) {
+    residency_manager->remove(*this);
+  }
+
   glDeleteTextures(1, &id);
 }
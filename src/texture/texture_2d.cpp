@@ -1,13 +1,86 @@
+#include <chrono>
+#include <iostream>
+
 #include "texture/texture_2d.hpp"
+#include "texture/image_cache.hpp"
+#include "texture/image_exception.hpp"
+#include "texture/pixel_store.hpp"
+#include "texture/residency_manager.hpp"
 
-Texture2D::Texture2D(const Image& img, GLenum index, Wrapping wrapping):
-  Texture(GL_TEXTURE_2D, index, wrapping, img.path)
+/* @param is_srgb Image colors in sRGB space (e.g. diffuse maps, not normal maps) */
+Texture2D::Texture2D(const Image& img, GLenum index, Wrapping wrapping, bool is_srgb):
+  Texture(GL_TEXTURE_2D, index, wrapping, img.path, is_srgb)
 {
   generate();
   configure();
   set_image(img);
 }
 
+/**
+ * Empty render target with an explicit format (e.g. GL_R32UI ids or GL_DEPTH_COMPONENT24 depth attached to a `Framebuffer`)
+ * Nearest filtering as integer textures can't be filtered linearly
+ * @param format_pixels/type_pixels Format of pixels read back from it (e.g. GL_RED_INTEGER & GL_UNSIGNED_INT)
+ */
+Texture2D::Texture2D(int w, int h, GLint internal_format, GLenum format_pixels, GLenum type_pixels, GLenum index):
+  Texture(GL_TEXTURE_2D, index, Wrapping::STRETCH),
+  width(w),
+  height(h)
+{
+  format = format_pixels;
+  m_internal_format = internal_format;
+
+  generate();
+  configure();
+  set_filters(GL_NEAREST, GL_NEAREST);
+
+  bind();
+  glTexImage2D(type, 0, m_internal_format, width, height, 0, format, type_pixels, NULL);
+  unbind();
+}
+
+/* Texture without storage (levels allocated later with `set_level()`) */
+Texture2D::Texture2D(GLenum index, Wrapping wrapping, const std::string& path, bool is_srgb):
+  Texture(GL_TEXTURE_2D, index, wrapping, path, is_srgb)
+{
+  generate();
+  configure();
+}
+
+/**
+ * Lazy texture: only the path is recorded, a 1x1 grey placeholder is bound until the image is uploaded
+ * Avoids blocking startup on textures not drawn yet
+ * @param is_async Decode in the background right away (otherwise decoded on first `attach()`)
+ * Upload happens in `attach()` (or `load()`) on the render thread once decoded
+ */
+Texture2D Texture2D::from_path(const std::string& path, GLenum index, Wrapping wrapping, bool is_async, bool flip, bool is_srgb) {
+  Texture2D texture(index, wrapping, path, is_srgb);
+
+  unsigned char pixel[4] = { 128, 128, 128, 255 };
+  texture.set_image(Image(1, 1, 4, pixel, false));
+
+  texture.m_source = std::make_shared<LazySource>(LazySource{ path, flip, is_async, false, FutureImage(), 1, 1 });
+  if (is_async) {
+    texture.m_source->image = ImageLoader::get().load(path, flip);
+  }
+
+  return texture;
+}
+
+/**
+ * Texture with only one (coarse) mip level resident, finer ones streamed later (see `StreamingManager`)
+ * @param level Mip level of given image (width & height set to those of level 0)
+ */
+Texture2D Texture2D::from_level(const Image& img, GLint level, GLenum index, Wrapping wrapping) {
+  Texture2D texture(index, wrapping, img.path);
+  texture.width = img.width << level;
+  texture.height = img.height << level;
+  texture.set_filters(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+  texture.set_level(img, level);
+  texture.set_levels_range(level, level);
+
+  return texture;
+}
+
 /**
  * Retrieve image data from opengl texture (gpu -> cpu)
  * Called before saving image the user painted on with nanovg in <imgui-paint>
@@ -18,7 +91,10 @@ Image Texture2D::get_image() {
   int n_channels = get_n_channels();
   Image image(width, height, n_channels, nullptr);
   image.data = new unsigned char[width * height * n_channels];
+  PixelStore pixel_store(true);
+  pixel_store.set_alignment(1);
   glGetTexImage(type, 0, format, GL_UNSIGNED_BYTE, image.data);
+  pixel_store.restore();
 
   unbind();
 
@@ -28,14 +104,51 @@ Image Texture2D::get_image() {
 /*
  * Update only subset of image texture
  * Used in `imgui-example` project so Brush tool is more fluid (no discontinuities between circles)
+ * @param subimage Tightly-packed pixels of given size
  */
 void Texture2D::set_subimage(const Image& subimage, const glm::uvec2& size, const glm::uvec2& offset) {
   // copy image subset to gpu (subimage pointer freed from calling code)
   bind();
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(PixelStore::get_alignment(size.x * subimage.n_channels));
   glTexSubImage2D(type, 0, offset.x, offset.y, size.x, size.y, format, GL_UNSIGNED_BYTE, subimage.data);
+  pixel_store.restore();
   unbind();
 }
 
+/**
+ * Update rectangle of texture from same rectangle in an image with the texture's size (e.g. <imgui-paint> canvas)
+ * Zero-copy: opengl reads the rectangle's rows in place from the whole image
+ */
+void Texture2D::set_subimage(const Image& image, const Rect& rect) {
+  bind();
+  upload_rect(image, rect);
+  unbind();
+}
+
+/* Batched version of above with a single bind (e.g. flushed by `DirtyRegion`) */
+void Texture2D::set_subimages(const Image& image, const std::vector<Rect>& rects) {
+  bind();
+
+  for (const Rect& rect : rects) {
+    upload_rect(image, rect);
+  }
+
+  unbind();
+}
+
+/**
+ * Rectangle located in image with row length (image width) & skipped rows/pixels
+ * Unpack state of calling code restored afterwards
+ */
+void Texture2D::upload_rect(const Image& image, const Rect& rect) {
+  PixelStore pixel_store(false);
+  pixel_store.set_rect(image.width, rect.x, rect.y);
+  pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(image.width) * image.n_channels));
+  glTexSubImage2D(type, 0, rect.x, rect.y, rect.width, rect.height, format, GL_UNSIGNED_BYTE, image.data);
+  pixel_store.restore();
+}
+
 /*
  * Set texture image
  * Used to update texture image from loaded path in `imgui-example` project
@@ -46,11 +159,99 @@ void Texture2D::set_image(const Image& image) {
   height = image.height;
   set_format(image.n_channels);
 
-  // copy image to gpu (image pointer could be freed after `glTexImage2D`)
+  // copy image to gpu (image pointer could be freed after `glTexImage2D`), rows of odd-width rgb images not 4-bytes aligned
   bind();
-  glTexImage2D(type, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, image.data);
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(width) * image.n_channels));
+  glTexImage2D(type, 0, m_internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, image.data);
+  pixel_store.restore();
   unbind();
 
+  if (residency_manager != nullptr) {
+    residency_manager->update(*this);
+  }
+
   // free image pointer
   image.free();
 }
+
+/**
+ * Upload image to given mip level (image pointer freed like in `set_image()`)
+ * Level only sampled once it's within [base level, max level]
+ */
+void Texture2D::set_level(const Image& image, GLint level) {
+  set_format(image.n_channels);
+
+  bind();
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(image.width) * image.n_channels));
+  glTexImage2D(type, level, m_internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+  pixel_store.restore();
+  unbind();
+
+  if (residency_manager != nullptr) {
+    residency_manager->update(*this);
+  }
+
+  image.free();
+}
+
+/* Release memory of mip level by respecifying it with an empty image */
+void Texture2D::free_level(GLint level) {
+  bind();
+  glTexImage2D(type, level, m_internal_format, 0, 0, 0, format, GL_UNSIGNED_BYTE, NULL);
+  unbind();
+
+  if (residency_manager != nullptr) {
+    residency_manager->update(*this);
+  }
+}
+
+/* Upload lazy texture's image if decoded (non-blocking when decoded in the background) */
+void Texture2D::attach() {
+  if (m_source != nullptr) {
+    bool is_decoded = !m_source->is_async ||
+      m_source->image.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+    if (!m_source->is_loaded && is_decoded) {
+      upload_source();
+    }
+
+    width = m_source->width;
+    height = m_source->height;
+  }
+
+  Texture::attach();
+}
+
+/* Always true for textures constructed from an image */
+bool Texture2D::is_loaded() const {
+  return m_source == nullptr || m_source->is_loaded;
+}
+
+/* Decode (waiting for background decoding if any) & upload lazy texture's image */
+void Texture2D::load() {
+  if (m_source != nullptr && !m_source->is_loaded) {
+    upload_source();
+    width = m_source->width;
+    height = m_source->height;
+  }
+}
+
+/* Placeholder kept if image not found */
+void Texture2D::upload_source() {
+  m_source->is_loaded = true;
+
+  try {
+    std::shared_ptr<const Image> image = m_source->is_async ?
+      m_source->image.get() :
+      ImageCache::get().load(m_source->path, m_source->flip);
+
+    set_image(*image);
+    m_source->width = width;
+    m_source->height = height;
+    m_source->image = FutureImage();
+  } catch (const ImageException& e) {
+    std::cout << e.what() << ": " << m_source->path << '\n';
+  }
+}
@@ -0,0 +1,82 @@
+#include "texture/texture_2d_array.hpp"
+#include "texture/texture_exception.hpp"
+#include "texture/pixel_store.hpp"
+
+/**
+ * @param images Layers of the array, all with the same size & # of channels
+ * @param has_mipmaps Generate mip chain (for layers sampled at a distance, e.g. terrain)
+ */
+Texture2DArray::Texture2DArray(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool has_mipmaps):
+  Texture(GL_TEXTURE_2D_ARRAY, index, wrapping, images.empty() ? "" : images[0].path),
+  width(images.empty() ? 0 : images[0].width),
+  height(images.empty() ? 0 : images[0].height),
+  n_layers(images.size()),
+  m_has_mipmaps(has_mipmaps)
+{
+  if (images.empty()) {
+    throw TextureException("Texture array without layers");
+  }
+
+  for (const Image& image : images) {
+    if (image.width != width || image.height != height || image.n_channels != images[0].n_channels) {
+      throw TextureException("Texture array layers have different sizes");
+    }
+  }
+
+  generate();
+  configure();
+  from_images(images);
+}
+
+/* Allocate storage for all layers at once then copy each image to its layer */
+void Texture2DArray::from_images(const std::vector<Image>& images) {
+  set_format(images[0].n_channels);
+
+  bind();
+  glTexImage3D(type, 0, m_internal_format, width, height, n_layers, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(width) * images[0].n_channels));
+  for (size_t i_layer = 0; i_layer < images.size(); i_layer++) {
+    glTexSubImage3D(type, 0, 0, 0, i_layer, width, height, 1, format, GL_UNSIGNED_BYTE, images[i_layer].data);
+  }
+  pixel_store.restore();
+  unbind();
+
+  if (m_has_mipmaps) {
+    generate_mipmaps();
+  }
+
+  // free images pointers
+  for (const Image& image : images) {
+    image.free();
+  }
+}
+
+/**
+ * Replace content of a single layer (image pointer freed like in `Texture2D::set_image()`)
+ * Mip chain regenerated for whole array (glGenerateMipmap() can't target a single layer)
+ * Image needs the array's size & # of channels (otherwise upload would read past its data)
+ */
+void Texture2DArray::set_layer(const Image& image, int i_layer) {
+  if (image.width != width || image.height != height || i_layer < 0 || i_layer >= n_layers) {
+    throw TextureException("Texture array layer out of bounds");
+  }
+
+  if (image.n_channels != get_n_channels()) {
+    throw TextureException("Texture array layer has a different # of channels");
+  }
+
+  bind();
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(width) * image.n_channels));
+  glTexSubImage3D(type, 0, 0, 0, i_layer, width, height, 1, format, GL_UNSIGNED_BYTE, image.data);
+  pixel_store.restore();
+  unbind();
+
+  if (m_has_mipmaps) {
+    generate_mipmaps();
+  }
+
+  image.free();
+}
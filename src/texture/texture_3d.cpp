@@ -1,15 +1,23 @@
+#include <cstdlib>
+
 #include "texture/texture_3d.hpp"
+#include "texture/cubemap.hpp"
+#include "texture/pixel_store.hpp"
+#include "texture/residency_manager.hpp"
 
 void Texture3D::from_images(const std::vector<Image>& images) {
   bind();
+  PixelStore pixel_store(false);
 
   // 6-sided texture cube using given images
   for (size_t i_texture = 0; i_texture < images.size(); i_texture++) {
     Image image = images[i_texture];
     set_format(image.n_channels);
-    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_texture, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+    pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(image.width) * image.n_channels));
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_texture, 0, m_internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
   }
 
+  pixel_store.restore();
   unbind();
 
   // free images pointers
@@ -27,17 +35,104 @@ void Texture3D::from_images(const std::vector<Image>& images) {
  * `std::vector` creates distinct image copies (copy by value) but with same data ptr
  *   => free only once to avoid double-free
  */
-Texture3D::Texture3D(const Image& image, GLenum index, Wrapping wrapping):
-  Texture3D(std::vector<Image>(6, image), index, wrapping, true)
+Texture3D::Texture3D(const Image& image, GLenum index, Wrapping wrapping, bool is_srgb):
+  Texture3D(std::vector<Image>(6, image), index, wrapping, true, is_srgb)
 {
 }
 
-/* Used also as a delegating constructor */
-Texture3D::Texture3D(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool is_same_image):
-  Texture(GL_TEXTURE_CUBE_MAP, index, wrapping, images[0].path),
+/**
+ * Used also as a delegating constructor
+ * @param is_srgb Faces colors in sRGB space (e.g. skybox)
+ */
+Texture3D::Texture3D(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool is_same_image, bool is_srgb):
+  Texture(GL_TEXTURE_CUBE_MAP, index, wrapping, images[0].path, is_srgb),
   m_is_same_image(is_same_image)
 {
   generate();
   configure();
   from_images(images);
 }
+
+/**
+ * Skybox from a single equirectangular panorama (instead of 6 images split offline)
+ * Panorama freed after conversion (like images given to other ctors)
+ * @param size Width & height of each face
+ */
+Texture3D Texture3D::from_equirectangular(const Image& image, int size, GLenum index, Wrapping wrapping) {
+  std::vector<Image> faces = Cubemap::from_equirectangular(image, size);
+  image.free();
+
+  return Texture3D(faces, index, wrapping);
+}
+
+/**
+ * Cubemap with a mip chain (e.g. specular environment map where each level matches a roughness)
+ * @param levels Six faces for each mip level (finest first)
+ * @param is_srgb Texels sRGB-encoded (internal format of all levels set by `set_format()`)
+ */
+Texture3D Texture3D::from_levels(const std::vector<std::vector<Image>>& levels, GLenum index, Wrapping wrapping, bool is_srgb) {
+  Texture3D texture(levels[0], index, wrapping, false, is_srgb);
+  for (size_t level = 1; level < levels.size(); level++) {
+    texture.set_level(levels[level], level);
+  }
+
+  if (levels.size() > 1) {
+    texture.set_filters(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+  }
+  texture.set_levels_range(0, levels.size() - 1);
+
+  return texture;
+}
+
+/* Upload 6 faces to given mip level (images pointers freed) */
+void Texture3D::set_level(const std::vector<Image>& images, GLint level) {
+  bind();
+  PixelStore pixel_store(false);
+
+  for (size_t i_face = 0; i_face < images.size(); i_face++) {
+    const Image& image = images[i_face];
+    set_format(image.n_channels);
+    pixel_store.set_alignment(PixelStore::get_alignment(static_cast<size_t>(image.width) * image.n_channels));
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_face, level, m_internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+  }
+
+  pixel_store.restore();
+  unbind();
+
+  if (residency_manager != nullptr) {
+    residency_manager->update(*this);
+  }
+
+  for (const Image& image : images) {
+    image.free();
+  }
+}
+
+/**
+ * Retrieve faces of given mip level (gpu -> cpu)
+ * @return Images allocated with malloc (freed with `Image::free()`)
+ */
+std::vector<Image> Texture3D::get_images(GLint level) {
+  int n_channels = get_n_channels();
+  std::vector<Image> images;
+
+  bind();
+  PixelStore pixel_store(true);
+  pixel_store.set_alignment(1);
+
+  for (size_t i_face = 0; i_face < 6; i_face++) {
+    GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i_face;
+    GLint width, height;
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+
+    unsigned char* data = static_cast<unsigned char*>(std::malloc(static_cast<size_t>(width) * height * n_channels));
+    glGetTexImage(target, level, format, GL_UNSIGNED_BYTE, data);
+    images.push_back(Image(width, height, n_channels, data));
+  }
+
+  pixel_store.restore();
+  unbind();
+
+  return images;
+}
@@ -0,0 +1,10 @@
+#include "texture/texture_exception.hpp"
+
+TextureException::TextureException(const std::string& message):
+  m_message(message)
+{
+}
+
+const char* TextureException::what() const noexcept {
+  return m_message.c_str();
+}
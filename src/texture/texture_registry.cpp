@@ -0,0 +1,114 @@
+#include "texture/texture_registry.hpp"
+#include "texture/image_hash.hpp"
+
+bool TextureRegistry::Key::operator==(const Key& other) const {
+  return hash == other.hash && type == other.type && wrapping == other.wrapping && is_srgb == other.is_srgb &&
+         width == other.width && height == other.height && n_channels == other.n_channels;
+}
+
+size_t TextureRegistry::KeyHash::operator()(const Key& key) const {
+  return key.hash ^ (key.type << 4) ^ (static_cast<size_t>(key.wrapping) << 1) ^ key.is_srgb;
+}
+
+/* Upload image unless a texture with same content, size, wrapping & color space was already created */
+Texture2D TextureRegistry::get_texture_2d(const Image& image, GLenum index, Wrapping wrapping, bool is_srgb) {
+  Key key = { ImageHash::get(image), GL_TEXTURE_2D, wrapping, is_srgb, image.width, image.height, image.n_channels };
+  auto it = m_textures_2d.find(key);
+
+  if (it == m_textures_2d.end()) {
+    it = m_textures_2d.emplace(key, Texture2D(image, index, wrapping, is_srgb)).first;
+    m_keys.emplace(it->second.id, key);
+  } else {
+    image.free();
+    m_n_duplicates++;
+  }
+
+  m_n_refs[it->second.id]++;
+  Texture2D texture = it->second;
+  texture.set_index(index);
+
+  return texture;
+}
+
+/* Same image on all 6 faces (see `Texture3D::Texture3D()`) */
+Texture3D TextureRegistry::get_texture_3d(const Image& image, GLenum index, Wrapping wrapping, bool is_srgb) {
+  return get_texture_3d(std::vector<Image>(6, image), index, wrapping, is_srgb, true);
+}
+
+Texture3D TextureRegistry::get_texture_3d(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool is_srgb) {
+  return get_texture_3d(images, index, wrapping, is_srgb, false);
+}
+
+/* Cubemap key made of its faces' hashes (in faces order) & of their size (same for all faces) */
+Texture3D TextureRegistry::get_texture_3d(const std::vector<Image>& images, GLenum index, Wrapping wrapping, bool is_srgb, bool is_same_image) {
+  uint64_t hash_face = 0;
+  std::vector<uint64_t> hashes;
+  for (size_t i_face = 0; i_face < images.size(); i_face++) {
+    // faces sharing same data ptr hashed once
+    if (!is_same_image || i_face == 0) {
+      hash_face = ImageHash::get(images[i_face]);
+    }
+    hashes.push_back(hash_face);
+  }
+
+  const Image& face = images[0];
+  Key key = { ImageHash::combine(hashes), GL_TEXTURE_CUBE_MAP, wrapping, is_srgb, face.width, face.height, face.n_channels };
+  auto it = m_textures_3d.find(key);
+
+  if (it == m_textures_3d.end()) {
+    it = m_textures_3d.emplace(key, Texture3D(images, index, wrapping, is_same_image, is_srgb)).first;
+    m_keys.emplace(it->second.id, key);
+  } else {
+    for (const Image& image : images) {
+      image.free();
+      if (is_same_image)
+        break;
+    }
+    m_n_duplicates++;
+  }
+
+  m_n_refs[it->second.id]++;
+  Texture3D texture = it->second;
+  texture.set_index(index);
+
+  return texture;
+}
+
+/* Gpu texture deleted when last texture sharing it is released */
+void TextureRegistry::release(const Texture& texture) {
+  auto it_refs = m_n_refs.find(texture.id);
+  if (it_refs == m_n_refs.end() || --it_refs->second > 0) {
+    return;
+  }
+
+  Key key = m_keys.at(texture.id);
+  texture.free();
+  m_textures_2d.erase(key);
+  m_textures_3d.erase(key);
+  m_keys.erase(texture.id);
+  m_n_refs.erase(it_refs);
+}
+
+/* # of distinct gpu textures */
+size_t TextureRegistry::get_n_textures() const {
+  return m_keys.size();
+}
+
+/* # of textures obtained without any upload */
+size_t TextureRegistry::get_n_duplicates() const {
+  return m_n_duplicates;
+}
+
+void TextureRegistry::free() {
+  for (const auto& item : m_textures_2d) {
+    item.second.free();
+  }
+  for (const auto& item : m_textures_3d) {
+    item.second.free();
+  }
+
+  m_textures_2d.clear();
+  m_textures_3d.clear();
+  m_n_refs.clear();
+  m_keys.clear();
+}
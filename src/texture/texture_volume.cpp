@@ -0,0 +1,101 @@
+#include <algorithm>
+
+#include "texture/texture_volume.hpp"
+#include "texture/texture_exception.hpp"
+#include "texture/pixel_store.hpp"
+
+/**
+ * Volume from a stack of same-sized slices (slice i at depth i)
+ * Throws without slices (first slice only read when present)
+ * @param brick_sz Edge in voxels of bricks updated by `set_brick()`
+ */
+TextureVolume::TextureVolume(const std::vector<Image>& slices, GLenum index, Wrapping wrapping, unsigned int brick_sz):
+  Texture(GL_TEXTURE_3D, index, wrapping, slices.empty() ? "" : slices[0].path),
+  size(0, 0, slices.size()),
+  brick_size(brick_sz)
+{
+  if (slices.empty()) {
+    throw TextureException("Volume without slices");
+  }
+
+  size.x = slices[0].width;
+  size.y = slices[0].height;
+
+  for (const Image& slice : slices) {
+    if (slice.width != slices[0].width || slice.height != slices[0].height || slice.n_channels != slices[0].n_channels) {
+      throw TextureException("Volume slices have different sizes");
+    }
+  }
+
+  generate();
+  configure();
+  allocate(slices[0].n_channels, NULL);
+
+  for (size_t i_slice = 0; i_slice < slices.size(); i_slice++) {
+    set_region(slices[i_slice].data, glm::uvec3(size.x, size.y, 1), glm::uvec3(0, 0, i_slice));
+  }
+
+  // free images pointers
+  for (const Image& slice : slices) {
+    slice.free();
+  }
+}
+
+/**
+ * Volume from raw voxels (x varying fastest, then y, then z) owned by calling code
+ * @param data Can be null to only allocate volume (filled later brick by brick)
+ */
+TextureVolume::TextureVolume(const glm::uvec3& sz, int n_channels, const unsigned char* data, GLenum index, Wrapping wrapping, unsigned int brick_sz):
+  Texture(GL_TEXTURE_3D, index, wrapping),
+  size(sz),
+  brick_size(brick_sz)
+{
+  generate();
+  configure();
+  allocate(n_channels, data);
+}
+
+/* Rows tightly packed (voxels often single-channel with sizes not multiple of 4) */
+void TextureVolume::allocate(int n_channels, const unsigned char* data) {
+  set_format(n_channels);
+
+  bind();
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(1);
+  glTexImage3D(type, 0, m_internal_format, size.x, size.y, size.z, 0, format, GL_UNSIGNED_BYTE, data);
+  pixel_store.restore();
+  unbind();
+}
+
+glm::uvec3 TextureVolume::get_n_bricks() const {
+  return glm::uvec3(
+    (size.x + brick_size - 1) / brick_size,
+    (size.y + brick_size - 1) / brick_size,
+    (size.z + brick_size - 1) / brick_size
+  );
+}
+
+/* Update box of voxels (data tightly packed, pointer freed by calling code) */
+void TextureVolume::set_region(const unsigned char* data, const glm::uvec3& sz, const glm::uvec3& offset) {
+  bind();
+  PixelStore pixel_store(false);
+  pixel_store.set_alignment(1);
+  glTexSubImage3D(type, 0, offset.x, offset.y, offset.z, sz.x, sz.y, sz.z, format, GL_UNSIGNED_BYTE, data);
+  pixel_store.restore();
+  unbind();
+}
+
+/**
+ * Update a single brick (bricks on the volume's far edges are cropped to its size)
+ * @param brick Brick coords (in bricks, not voxels)
+ */
+void TextureVolume::set_brick(const unsigned char* data, const glm::uvec3& brick) {
+  glm::uvec3 offset = brick * brick_size;
+  glm::uvec3 sz(
+    std::min(brick_size, size.x - offset.x),
+    std::min(brick_size, size.y - offset.y),
+    std::min(brick_size, size.z - offset.z)
+  );
+
+  set_region(data, sz, offset);
+}
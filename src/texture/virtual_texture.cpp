@@ -0,0 +1,97 @@
+#include "texture/virtual_texture.hpp"
+#include "texture/texture_exception.hpp"
+
+/**
+ * @param source Tiled image (tiles should include their own border texels to avoid bleeding with bilinear filtering)
+ * @param n_pages_side Physical cache holds `n_pages_side^2` pages (at most 256 as page table stores 8-bits coords)
+ * @param n_uploads_max Max # of pages uploaded in `update()`
+ */
+VirtualTexture::VirtualTexture(TileSource& source, unsigned int n_pages_side, unsigned int n_uploads_max,
+                               GLenum index_cache, GLenum index_page_table):
+  m_source(source),
+  m_page_manager(n_pages_side * n_pages_side),
+  m_n_pages_side(n_pages_side),
+  m_n_uploads_max(n_uploads_max)
+{
+  if (n_pages_side == 0 || n_pages_side > 256) {
+    throw TextureException("Virtual texture cache must have between 1 & 256 pages per side");
+  }
+
+  // physical cache allocated without data (filled page by page)
+  int size_cache = n_pages_side * source.get_tile_size();
+  cache = Texture2D(Image(size_cache, size_cache, source.get_n_channels(), nullptr, false), index_cache, Wrapping::STRETCH);
+
+  // all pages initially not resident
+  glm::uvec2 n_tiles = source.get_n_tiles();
+  std::vector<unsigned char> entries(n_tiles.x * n_tiles.y * 4, 0);
+  page_table = Texture2D(Image(n_tiles.x, n_tiles.y, 4, entries.data(), false), index_page_table, Wrapping::STRETCH);
+  page_table.set_filters(GL_NEAREST, GL_NEAREST);
+}
+
+uint64_t VirtualTexture::get_key(const glm::uvec2& page) {
+  return (static_cast<uint64_t>(page.y) << 32) | page.x;
+}
+
+glm::uvec2 VirtualTexture::get_page(uint64_t key) {
+  return glm::uvec2(key & 0xffffffff, key >> 32);
+}
+
+/**
+ * Mark page as needed for current frame (e.g. from visible area or feedback pass)
+ * To call each frame before `update()`, as requests are cleared after every update
+ */
+void VirtualTexture::request(const glm::uvec2& page) {
+  glm::uvec2 n_tiles = m_source.get_n_tiles();
+  if (page.x >= n_tiles.x || page.y >= n_tiles.y) {
+    return;
+  }
+
+  uint64_t key = get_key(page);
+  if (m_keys_requested.insert(key).second) {
+    m_requests.push_back(page);
+  }
+}
+
+/* Load & upload requested pages that aren't resident yet (within upload budget, see `PageManager::load_missing()`) */
+void VirtualTexture::update() {
+  int tile_size = m_source.get_tile_size();
+  std::vector<uint64_t> keys;
+  for (const glm::uvec2& page : m_requests) {
+    keys.push_back(get_key(page));
+  }
+
+  m_page_manager.load_missing(keys, m_n_uploads_max, [&](uint64_t key, const PageSlot& page_slot) {
+    if (page_slot.has_evicted) {
+      set_page_table_entry(get_page(page_slot.key_evicted), 0, false);
+    }
+
+    // copy tile to its slot in the physical cache
+    glm::uvec2 page = get_page(key);
+    glm::uvec2 offset(page_slot.slot % m_n_pages_side, page_slot.slot / m_n_pages_side);
+    Image tile = m_source.get_tile(page);
+    cache.set_subimage(tile, glm::uvec2(tile_size, tile_size), offset * static_cast<unsigned int>(tile_size));
+    tile.free();
+
+    set_page_table_entry(page, page_slot.slot, true);
+  });
+
+  m_requests.clear();
+  m_keys_requested.clear();
+}
+
+/* Point page table's texel to page's position in cache */
+void VirtualTexture::set_page_table_entry(const glm::uvec2& page, unsigned int slot, bool is_resident) {
+  unsigned char entry[4] = {
+    static_cast<unsigned char>(slot % m_n_pages_side),
+    static_cast<unsigned char>(slot / m_n_pages_side),
+    0,
+    static_cast<unsigned char>(is_resident ? 255 : 0),
+  };
+
+  page_table.set_subimage(Image(1, 1, 4, entry, false), glm::uvec2(1, 1), page);
+}
+
+void VirtualTexture::free() {
+  cache.free();
+  page_table.free();
+}